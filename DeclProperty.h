@@ -9,6 +9,13 @@ Part of my MUtilize repo: https://github.com/LegendaryMauricius/MUtilize
 #define _DECL_PROPERTY_H
 
 #include <type_traits>
+#include <cstddef>
+#include <utility>
+#include <cstdint>
+#include <bit>
+#include <atomic>
+#include <cstring>
+#include <thread>
 
 /*
 Declares a property member.
@@ -18,20 +25,91 @@ to the type of the class.
 #define decl_property(NAME, ...) _decl_property_impl(NAME, __VA_ARGS__)
 
 /*
-Enables usage of this_owner inside a class' property's methods.
-Use AFTER defining the owner class.
-If enable_this_owner is used on a property, it has to be the single
-member of its property type.
+Declares a property whose value is computed by 'decl_compute()' and then cached,
+until it's invalidated with NAME.invalidate() or by a property that lists it in 'decl_invalidates'.
+The getter returns a const reference to the cached value, so TYPE has to be default constructible.
+Only cached properties store anything; other properties stay empty.
+*/
+#define decl_cached_property(NAME, TYPE, ...) _decl_property_impl(NAME, enable_property_cache(TYPE); __VA_ARGS__)
+
+/*
+Declares a property whose changes are tracked in the owner's dirty mask, with the bit right after the tracked property PREV.
+The first tracked property uses 'tracked_start' as PREV.
+The owner must use 'enable_property_tracking' before declaring its tracked properties, and can have up to 64 of them.
+Setters mark the property dirty with 'tracked_set' or 'mark_dirty()'.
 Example:
-    enable_this_owner(Owner::Member);
+    decl_tracked_property(health, tracked_start, enable_property_defaults(int); default_get(); tracked_set(););
+    decl_tracked_property(mana, health, enable_property_defaults(int); default_get(); tracked_set(););
 */
-#define enable_this_owner(PROP_OWNER_T, MEMBER_NAME) constexpr PROP_OWNER_T::property_##MEMBER_NAME##_t PROP_OWNER_T::* PROP_OWNER_T::property_##MEMBER_NAME##_t::_this_member_ptr() {return &PROP_OWNER_T::MEMBER_NAME;}
+#define decl_tracked_property(NAME, PREV, ...) _decl_property_impl(NAME, enable_property_index(NAME, PREV); __VA_ARGS__);\
+	inline auto& _property_tracked(std::integral_constant<int, property_##NAME##_t::property_index>) {return NAME;}\
+	static_assert(property_##NAME##_t::property_index < 64, "An owner can have up to 64 tracked properties!")
+
+/*
+Declares a property stored in BITS bits of the owner's packed word, right after the packed property PREV.
+The first packed property uses 'packed_start' as PREV.
+The owner must use 'enable_packed_properties'.
+TYPE can be an integer, a bool or an enum. Signed integers are sign-extended,
+while enums are stored as unsigned, so their values have to be non-negative and fit in BITS bits.
+Example:
+    decl_packed_property(visible, packed_start, bool, 1, packed_get(); packed_set(););
+    decl_packed_property(kind, visible, Kind, 3, packed_get(); packed_set(););
+*/
+#define decl_packed_property(NAME, PREV, TYPE, BITS, ...) _decl_property_impl(NAME, enable_property_packing(PREV, TYPE, BITS); __VA_ARGS__)
+
+/*
+Enables packed properties in a class, all stored in a single WORD, which must be an unsigned integer type.
+Used inside the owner class, before the packed properties.
+*/
+#define enable_packed_properties(WORD) \
+	struct property_packed_start_t {static constexpr unsigned _property_packed_end = 0;};\
+	WORD _property_packed_word = 0
+
+/*
+Enables tracking of property changes in a class, with a single 64 bit dirty mask.
+Adds dirty_mask(), clear_dirty() and for_each_dirty(f), which calls f with each dirty tracked property,
+in the order of declaration, and clears the mask in the same pass.
+Used inside the owner class, before the tracked properties.
+*/
+#define enable_property_tracking() \
+	struct property_tracked_start_t {static constexpr int _property_tracked_next = 0;};\
+	inline uint64_t dirty_mask() const {return _property_dirty_mask;}\
+	inline void clear_dirty() {_property_dirty_mask = 0;}\
+	template<class _F>\
+	inline void for_each_dirty(_F&& f) {\
+		uint64_t mask = _property_dirty_mask;\
+		_property_dirty_mask = 0;\
+		while (mask) {\
+			int index = std::countr_zero(mask);\
+			mask &= mask - 1;\
+			_property_visit_dirty(index, f, std::make_integer_sequence<int, 64>());\
+		}\
+	}\
+	template<class _F, int... _Is>\
+	inline void _property_visit_dirty(int index, _F& f, std::integer_sequence<int, _Is...>) {\
+		((index == _Is ? _property_visit_dirty_at<_Is>(f) : void()), ...);\
+	}\
+	template<int _I, class _F>\
+	inline void _property_visit_dirty_at(_F& f) {\
+		if constexpr (requires { this->_property_tracked(std::integral_constant<int, _I>()); })\
+			f(this->_property_tracked(std::integral_constant<int, _I>()));\
+	}\
+	uint64_t _property_dirty_mask = 0
+
+/*
+Used to enable this_owner in a property, which now works in every property without it.
+Kept so that existing code compiles. Does nothing.
+Example:
+    enable_this_owner(Owner, Member);
+*/
+#define enable_this_owner(PROP_OWNER_T, MEMBER_NAME) static_assert(true, "")
 
 /*
 Pointer to  the owner of the property.
-'this' points to the property member itself, so use 'this_owner' instead
+'this' points to the property member itself, so use 'this_owner' instead.
+The offset of the property in the owner is a compile-time constant, so this compiles to a direct access of the owner's members.
 */
-#define this_owner ((property_owner_t*)((char*)this - _PROP_OFFSET_OF_MEMBER_PTR(property_owner_t, _this_member_ptr())))
+#define this_owner ((property_owner_t*)((char*)this - std::integral_constant<size_t, _this_offset()>::value))
 
 
 /*
@@ -45,6 +123,30 @@ It can be used to either only declare a setter, or define it later.
 */
 #define decl_set(TYPE_VAL) operator=(TYPE_VAL)
 
+/*
+Declares the value type of a property with custom accessors, for 'reflect_properties'.
+Not needed for properties with a base type, such as defaults, atomic, packed and cached ones.
+*/
+#define decl_value_type(TYPE) using _property_value_decl_t = TYPE
+
+/*
+Registers the listed properties of the class for compile-time reflection.
+Adds the static for_each_property(f), which calls f with a _property_info for each property in the listed order,
+and property_count(). A _property_info has the property's name, its value type and its accessor.
+Used inside the owner class, after the properties.
+Example:
+    reflect_properties(width, height, title);
+    ...
+    Owner::for_each_property([&](auto info) {
+        std::cout << info.name << " = " << (typename decltype(info)::value_t)info.get(owner) << std::endl;
+    });
+*/
+#define reflect_properties(...) \
+	template<class _F>\
+	static constexpr void for_each_property(_F&& f) {_PROP_FOR_EACH(_PROP_REFLECT, __VA_ARGS__)}\
+	static constexpr size_t property_count() {size_t count = 0; for_each_property([&](auto) {count++;}); return count;}\
+	using _property_reflected_t = void
+
 /*
 Enables usage of 'default_get' and 'default_set'.
 Requires specifying a base property type.
@@ -57,7 +159,122 @@ Declares a default getter
 /*
 Declares a default setter
 */
-#define default_set() inline void operator=(_property_base_t&& val) {_property_value = val;}
+#define default_set() inline void operator=(_property_base_t&& val) {_property_value = val; _property_notify_dependents(this);}
+
+/*
+Enables usage of 'atomic_get' and 'atomic_set', with a std::atomic<BASETYPE> base value,
+so the property can be written and read by different threads without locking.
+GET_ORDER and SET_ORDER are the std::memory_orders of the loads and stores.
+Example:
+    enable_property_atomic(float, std::memory_order_relaxed, std::memory_order_relaxed);
+*/
+#define enable_property_atomic(BASETYPE, GET_ORDER, SET_ORDER) \
+	using _property_base_t = BASETYPE;\
+	static constexpr std::memory_order _property_get_order = GET_ORDER;\
+	static constexpr std::memory_order _property_set_order = SET_ORDER;\
+	std::atomic<_property_base_t> _property_value
+/*
+Like 'enable_property_atomic', but with a seqlock instead of a std::atomic,
+for types that aren't lock-free, such as small structs. BASETYPE has to be trivially copyable.
+Readers never block the writers and never take a mutex, but retry when they overlap a write.
+Loads are acquires and stores are releases.
+*/
+#define enable_property_seqlock(BASETYPE) \
+	using _property_base_t = BASETYPE;\
+	static constexpr std::memory_order _property_get_order = std::memory_order_acquire;\
+	static constexpr std::memory_order _property_set_order = std::memory_order_release;\
+	_property_seqlock<_property_base_t> _property_value
+/*
+Declares a getter that atomically loads the value
+*/
+#define atomic_get() inline operator _property_base_t () const {return _property_value.load(_property_get_order);}
+/*
+Declares a setter that atomically stores the value.
+Cached dependents aren't invalidated, since their caches aren't thread-safe.
+*/
+#define atomic_set() inline void operator=(const _property_base_t& val) {_property_value.store(val, _property_set_order);}
+
+/*
+Gives the property its bits in the owner's packed word. Used by 'decl_packed_property'.
+*/
+#define enable_property_packing(PREV, TYPE, BITS) \
+	using _property_base_t = TYPE;\
+	using _property_packed_t = _property_packed<decltype(property_owner_t::_property_packed_word), TYPE,\
+		property_owner_t::property_##PREV##_t::_property_packed_end, BITS>;\
+	static constexpr unsigned _property_packed_end = _property_packed_t::end
+/*
+Declares a getter that extracts the value from the packed word
+*/
+#define packed_get() inline operator _property_base_t () const {return _property_packed_t::load(this_owner->_property_packed_word);}
+/*
+Declares a default setter that inserts the value into the packed word
+*/
+#define packed_set() inline void operator=(const _property_base_t& val) {packed_store(val); _property_notify_dependents(this);}
+/*
+Inserts the value into the packed word. Call it from custom setters, e.g. after validating the value.
+*/
+#define packed_store(VAL) _property_packed_t::store(this_owner->_property_packed_word, VAL)
+
+/*
+Declares a default setter that marks the property dirty only if the value changes.
+Used with 'decl_tracked_property'. The base type needs operator==.
+*/
+#define tracked_set() inline void operator=(const _property_base_t& val) {if (!(_property_value == val)) {_property_value = val; mark_dirty(); _property_notify_dependents(this);}}
+/*
+Declares a default setter that marks the property dirty on every write, even if the value doesn't change.
+Used with 'decl_tracked_property'.
+*/
+#define tracked_set_always() inline void operator=(const _property_base_t& val) {_property_value = val; mark_dirty(); _property_notify_dependents(this);}
+/*
+Marks the tracked property dirty. Call it from custom setters.
+*/
+#define mark_dirty() (this_owner->_property_dirty_mask |= (uint64_t)1 << property_index)
+
+/*
+Gives the property the index after PREV's in the owner's dirty mask, and its name. Used by 'decl_tracked_property'.
+*/
+#define enable_property_index(NAME, PREV) \
+	static constexpr int property_index = property_owner_t::property_##PREV##_t::_property_tracked_next;\
+	static constexpr int _property_tracked_next = property_index + 1;\
+	static constexpr const char* property_name() {return #NAME;}
+
+/*
+Enables caching of a computed value. Used by 'decl_cached_property'.
+Adds the cached getter and invalidate(), which also invalidates the dependents if the value was cached.
+*/
+#define enable_property_cache(TYPE) \
+	using _property_cached_t = TYPE;\
+	mutable _property_cache<TYPE> _property_cache_data;\
+public:\
+	inline operator const _property_cached_t& () const {\
+		if (!_property_cache_data.valid) {\
+			_property_cache_data.value = _property_compute();\
+			_property_cache_data.valid = true;\
+		}\
+		return _property_cache_data.value;\
+	}\
+	inline void invalidate() const {\
+		if (_property_cache_data.valid) {\
+			_property_cache_data.valid = false;\
+			_property_notify_dependents(this);\
+		}\
+	}
+/*
+Declaration of the function that computes a cached property's value.
+Used inside the 'decl_cached_property' body.
+*/
+#define decl_compute() _property_cached_t _property_compute() const
+
+/*
+Lists the cached properties of the owner that depend on this property.
+Their caches are invalidated by 'default_set' and 'invalidate_dependents()'.
+*/
+#define decl_invalidates(...) inline void _property_invalidate_dependents() const {_PROP_FOR_EACH(_PROP_INVALIDATE, __VA_ARGS__)}
+/*
+Invalidates the dependents listed in 'decl_invalidates'. Call it from custom setters.
+Does nothing if the property has no dependents.
+*/
+#define invalidate_dependents() _property_notify_dependents(this)
 
 
 /*
@@ -84,7 +301,6 @@ public:
 
     int a;
 };
-enable_this_owner(PropOwner, a_prop);
 */
 
 /*
@@ -102,6 +318,105 @@ public:
 };
 */
 
+/*
+// cached example
+class PropOwner
+{
+public:
+    using property_owner_t = PropOwner;
+
+    decl_property(side,
+        enable_property_defaults(double);
+        default_get();
+        default_set();
+        decl_invalidates(area);
+    );
+
+    decl_cached_property(area, double,
+        decl_compute()
+        {
+            return (double)this_owner->side * this_owner->side;
+        }
+    );
+};
+*/
+
+/*
+// atomic example, written by one thread and read by many
+class PropOwner
+{
+public:
+    using property_owner_t = PropOwner;
+
+    decl_property(gain,
+        enable_property_atomic(float, std::memory_order_relaxed, std::memory_order_relaxed);
+        atomic_get();
+        atomic_set();
+    );
+
+    struct Range { float min, max; };
+    decl_property(range,
+        enable_property_seqlock(Range);
+        atomic_get();
+        atomic_set();
+    );
+};
+*/
+
+/*
+// packed example, taking 2 bytes in total
+class PropOwner
+{
+public:
+    using property_owner_t = PropOwner;
+    enable_packed_properties(uint16_t);
+
+    enum class Kind { Rock, Paper, Scissors };
+
+    decl_packed_property(visible, packed_start, bool, 1,
+        packed_get();
+        packed_set();
+    );
+    decl_packed_property(kind, visible, Kind, 2,
+        packed_get();
+        packed_set();
+    );
+    decl_packed_property(level, kind, int, 5,
+        packed_get();
+        void decl_set(int val)
+        {
+            packed_store(std::clamp(val, 0, 15));
+        }
+    );
+};
+*/
+
+/*
+// tracked example
+class PropOwner
+{
+public:
+    using property_owner_t = PropOwner;
+    enable_property_tracking();
+
+    decl_tracked_property(health, tracked_start,
+        enable_property_defaults(int);
+        default_get();
+        tracked_set();
+    );
+    decl_tracked_property(name, health,
+        enable_property_defaults(std::string);
+        default_get();
+        tracked_set();
+    );
+};
+
+// serializing only the changes
+owner.for_each_dirty([&](auto& prop) {
+    out << prop.property_name() << " = " << prop << std::endl;
+});
+*/
+
 /*
 // read-only example (writable by the PropOwner)
 class PropOwner
@@ -124,16 +439,210 @@ public:
 UTILITIES
 */
 
-#define _PROP_OFFSET_OF_MEMBER_PTR(OWNER, MEMBER_PTR) ((char*)&((OWNER*)nullptr->*(MEMBER_PTR)) - (char*)nullptr)
-#define _PROP_OFFSET_OF_MEMBER(OWNER, MEMBER) ((char*)&((OWNER*)nullptr->*(&OWNER::MEMBER)) - (char*)nullptr)
+template<class _T>
+struct _property_cache
+{
+	_T value = _T();
+	bool valid = false;
+};
+
+/*
+A seqlock for values that are written by one thread at a time and read by many.
+The value is stored in relaxed atomic words, so readers that overlap a write read a torn copy without a data race,
+and then retry when they see that the sequence number has changed.
+*/
+template<class _T>
+class _property_seqlock
+{
+	static_assert(std::is_trivially_copyable<_T>::value, "Seqlock properties need a trivially copyable type!");
+
+	static constexpr size_t _wordCount = (sizeof(_T) + sizeof(uint64_t) - 1) / sizeof(uint64_t);
+
+	std::atomic<uint64_t> mSequence;// Odd while a write is in progress
+	std::atomic<uint64_t> mWords[_wordCount];
+
+	void storeWords(const _T& val) {
+		uint64_t words[_wordCount] = {};
+		memcpy(words, &val, sizeof(_T));
+		for (size_t i = 0; i < _wordCount; i++) {
+			mWords[i].store(words[i], std::memory_order_relaxed);
+		}
+	}
+
+public:
+	_property_seqlock() : mSequence(0) {
+		storeWords(_T());
+	}
+
+	_property_seqlock(const _property_seqlock&) = delete;
+	_property_seqlock& operator=(const _property_seqlock&) = delete;
+
+	_T load(std::memory_order = std::memory_order_acquire) const {
+		uint64_t words[_wordCount];
+		for (;;) {
+			uint64_t seq = mSequence.load(std::memory_order_acquire);
+			if (seq & 1) {
+				std::this_thread::yield();
+				continue;
+			}
+			for (size_t i = 0; i < _wordCount; i++) {
+				words[i] = mWords[i].load(std::memory_order_relaxed);
+			}
+			std::atomic_thread_fence(std::memory_order_acquire);
+			if (mSequence.load(std::memory_order_relaxed) == seq)
+				break;
+		}
+
+		_T val;
+		memcpy(&val, words, sizeof(_T));
+		return val;
+	}
+
+	// Concurrent writers are serialized by spinning on the sequence number
+	void store(const _T& val, std::memory_order = std::memory_order_release) {
+		uint64_t seq = mSequence.load(std::memory_order_relaxed);
+		while ((seq & 1) || !mSequence.compare_exchange_weak(seq, seq + 1, std::memory_order_acquire, std::memory_order_relaxed)) {
+			if (seq & 1) {
+				std::this_thread::yield();
+				seq = mSequence.load(std::memory_order_relaxed);
+			}
+		}
+		std::atomic_thread_fence(std::memory_order_release);
+		storeWords(val);
+		mSequence.store(seq + 2, std::memory_order_release);
+	}
+};
+
+/*
+The value type of a property: the base type of the defaults, atomic and seqlock properties,
+the cached type of the cached properties, or the type from 'decl_value_type'. void if none of them is known.
+*/
+template<class _PropT>
+constexpr auto _property_value_type() {
+	if constexpr (requires { typename _PropT::_property_base_t; })
+		return std::type_identity<typename _PropT::_property_base_t>();
+	else if constexpr (requires { typename _PropT::_property_cached_t; })
+		return std::type_identity<typename _PropT::_property_cached_t>();
+	else if constexpr (requires { typename _PropT::_property_value_decl_t; })
+		return std::type_identity<typename _PropT::_property_value_decl_t>();
+	else
+		return std::type_identity<void>();
+}
+
+template<class _PropT>
+using _property_value_t = typename decltype(_property_value_type<_PropT>())::type;
+
+// Compile-time information about a reflected property. See 'reflect_properties'.
+template<class _OwnerT, auto _Member>
+struct _property_info
+{
+	using owner_t = _OwnerT;
+	using property_t = std::remove_reference_t<decltype(std::declval<_OwnerT&>().*_Member)>;
+	using value_t = _property_value_t<property_t>;
+
+	static constexpr auto member = _Member;
+	const char* name;
+
+	static constexpr property_t& get(_OwnerT& owner) {
+		return owner.*_Member;
+	}
+
+	static constexpr const property_t& get(const _OwnerT& owner) {
+		return owner.*_Member;
+	}
+};
+
+#define _PROP_REFLECT(NAME) f(_property_info<property_owner_t, &property_owner_t::NAME>{#NAME});
+
+// Extracts and inserts a value of _T, stored in _Bits bits of _WordT starting at bit _Offset
+template<class _WordT, class _T, unsigned _Offset, unsigned _Bits>
+struct _property_packed
+{
+	static_assert(std::is_unsigned<_WordT>::value, "The packed word has to be an unsigned integer!");
+	static_assert(_Bits > 0 && _Offset + _Bits <= sizeof(_WordT) * 8, "The packed properties don't fit in the word!");
+	static_assert(std::is_integral<_T>::value || std::is_enum<_T>::value, "Packed properties have to be integers, bools or enums!");
+
+	using _IntT = typename std::conditional_t<std::is_enum<_T>::value, std::underlying_type<_T>, std::type_identity<_T> >::type;
+
+	static constexpr unsigned end = _Offset + _Bits;
+	static constexpr uint64_t valueMask = (_Bits == 64) ? ~(uint64_t)0 : ((uint64_t)1 << _Bits) - 1;
+	static constexpr _WordT mask = (_WordT)(valueMask << _Offset);
+
+	static constexpr _T load(_WordT word) {
+		uint64_t bits = ((uint64_t)word >> _Offset) & valueMask;
+		if constexpr (std::is_same<_T, bool>::value) {
+			return bits != 0;
+		}
+		else if constexpr (std::is_signed<_T>::value) {
+			// Sign-extends the top bit with an arithmetic shift. Enums aren't, even with a signed underlying type.
+			return (_T)(_IntT)((int64_t)(bits << (64 - _Bits)) >> (64 - _Bits));
+		}
+		else {
+			return (_T)(_IntT)bits;
+		}
+	}
+
+	static constexpr void store(_WordT& word, _T val) {
+		if constexpr (_Offset % 8 == 0 && (_Bits == 8 || _Bits == 16 || _Bits == 32) && _Bits < sizeof(_WordT) * 8) {
+			// Byte-aligned values are stored directly into their bytes, like compilers do with byte-aligned bitfields,
+			// so the rest of the word isn't read and written back
+			if (!std::is_constant_evaluated()) {
+				using _BytesT = std::conditional_t<_Bits == 8, uint8_t, std::conditional_t<_Bits == 16, uint16_t, uint32_t> >;
+				constexpr size_t byte = (std::endian::native == std::endian::little) ?
+					_Offset / 8 : sizeof(_WordT) - (_Offset + _Bits) / 8;
+				_BytesT bytes = (_BytesT)(_IntT)val;
+				memcpy((unsigned char*)&word + byte, &bytes, sizeof(bytes));
+				return;
+			}
+		}
+		word = (_WordT)((word & ~mask) | (((uint64_t)(_IntT)val << _Offset) & mask));
+	}
+};
+
+// Calls the property's _property_invalidate_dependents() if it was declared with 'decl_invalidates'
+template<class _PropT>
+inline void _property_notify_dependents(const _PropT* prop) {
+	if constexpr (requires { prop->_property_invalidate_dependents(); })
+		prop->_property_invalidate_dependents();
+}
+
+#define _PROP_INVALIDATE(NAME) this_owner->NAME.invalidate();
+
+// Calls MACRO for each of the arguments
+#define _PROP_FOR_EACH(MACRO, ...) __VA_OPT__(_PROP_EXPAND(_PROP_FOR_EACH_HELPER(MACRO, __VA_ARGS__)))
+#define _PROP_FOR_EACH_HELPER(MACRO, A, ...) MACRO(A) __VA_OPT__(_PROP_FOR_EACH_AGAIN _PROP_PARENS (MACRO, __VA_ARGS__))
+#define _PROP_FOR_EACH_AGAIN() _PROP_FOR_EACH_HELPER
+#define _PROP_PARENS ()
+#define _PROP_EXPAND(...) _PROP_EXPAND3(_PROP_EXPAND3(_PROP_EXPAND3(_PROP_EXPAND3(__VA_ARGS__))))
+#define _PROP_EXPAND3(...) _PROP_EXPAND2(_PROP_EXPAND2(_PROP_EXPAND2(_PROP_EXPAND2(__VA_ARGS__))))
+#define _PROP_EXPAND2(...) _PROP_EXPAND1(_PROP_EXPAND1(_PROP_EXPAND1(_PROP_EXPAND1(__VA_ARGS__))))
+#define _PROP_EXPAND1(...) __VA_ARGS__
+
+/*
+Owners with properties aren't standard layout, for which offsetof is only conditionally supported.
+All the supported compilers compute it at compile time, but GCC and Clang warn about it.
+*/
+#if defined(__GNUC__) || defined(__clang__)
+#define _PROP_OFFSETOF_BEGIN _Pragma("GCC diagnostic push") _Pragma("GCC diagnostic ignored \"-Winvalid-offsetof\"")
+#define _PROP_OFFSETOF_END _Pragma("GCC diagnostic pop")
+#else
+#define _PROP_OFFSETOF_BEGIN
+#define _PROP_OFFSETOF_END
+#endif
+
 #define _decl_property_impl(NAME, ...)\
 	[[no_unique_address]][[msvc::no_unique_address]] struct property_##NAME##_t {\
         friend property_owner_t;\
+    private:\
+        static constexpr size_t _this_offset() {\
+            _PROP_OFFSETOF_BEGIN\
+            return offsetof(property_owner_t, NAME);\
+            _PROP_OFFSETOF_END\
+        }\
+    public:\
 		\
 		__VA_ARGS__\
 		\
-    private:\
-        static constexpr property_##NAME##_t PropOwner::* _this_member_ptr();\
 	}  NAME
 
 #endif
\ No newline at end of file
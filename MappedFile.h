@@ -0,0 +1,183 @@
+/*
+Made by Mauricius
+
+Part of my MUtilize repo: https://github.com/LegendaryMauricius/MUtilize
+*/
+
+#pragma once
+#ifndef _MAPPED_FILE_H
+#define _MAPPED_FILE_H
+
+#include <string>
+#include <stdexcept>
+#include <utility>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+/*
+A read-only memory mapping of a whole file.
+The mapped bytes are backed by the OS page cache, so all the processes mapping the same file share the same memory.
+The mapping is movable, but not copyable.
+*/
+class MappedFile
+{
+private:
+	const char* mData;
+	size_t mSize;
+#ifdef _WIN32
+	HANDLE mFile;
+	HANDLE mMapping;
+#endif
+
+public:
+
+	struct FileError : public std::runtime_error {
+		FileError(const std::string& what) : std::runtime_error(what) {}
+	};
+
+	MappedFile() noexcept :
+		mData(nullptr),
+		mSize(0)
+#ifdef _WIN32
+		, mFile(INVALID_HANDLE_VALUE),
+		mMapping(NULL)
+#endif
+	{}
+
+	// Maps the file. Throws FileError if it can't be opened or mapped.
+	explicit MappedFile(const std::string& filename) :
+		MappedFile()
+	{
+		open(filename);
+	}
+
+	MappedFile(MappedFile&& other) noexcept :
+		MappedFile()
+	{
+		swap(other);
+	}
+
+	MappedFile& operator=(MappedFile&& other) noexcept {
+		MappedFile tmp(std::move(other));
+		swap(tmp);
+		return *this;
+	}
+
+	MappedFile(const MappedFile&) = delete;
+	MappedFile& operator=(const MappedFile&) = delete;
+
+	~MappedFile() {
+		close();
+	}
+
+	void swap(MappedFile& other) noexcept {
+		std::swap(mData, other.mData);
+		std::swap(mSize, other.mSize);
+#ifdef _WIN32
+		std::swap(mFile, other.mFile);
+		std::swap(mMapping, other.mMapping);
+#endif
+	}
+
+	/*
+	Maps the whole file, unmapping the previously mapped one.
+	Empty files are valid and result in a non-null data() with size() 0.
+	Throws FileError if the file can't be opened or mapped.
+	*/
+	void open(const std::string& filename) {
+		static const char empty[1] = { 0 };
+		close();
+
+#ifdef _WIN32
+		mFile = CreateFileA(filename.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+		if (mFile == INVALID_HANDLE_VALUE)
+			throw FileError("Can't open file \"" + filename + "\"!");
+
+		LARGE_INTEGER size;
+		if (!GetFileSizeEx(mFile, &size)) {
+			close();
+			throw FileError("Can't get the size of file \"" + filename + "\"!");
+		}
+		mSize = (size_t)size.QuadPart;
+
+		if (mSize == 0) {
+			mData = empty;
+			return;
+		}
+		mMapping = CreateFileMappingA(mFile, NULL, PAGE_READONLY, 0, 0, NULL);
+		if (mMapping != NULL)
+			mData = (const char*)MapViewOfFile(mMapping, FILE_MAP_READ, 0, 0, 0);
+		if (!mData) {
+			close();
+			throw FileError("Can't map file \"" + filename + "\"!");
+		}
+#else
+		int fd = ::open(filename.c_str(), O_RDONLY);
+		if (fd < 0)
+			throw FileError("Can't open file \"" + filename + "\"!");
+
+		struct stat st;
+		if (fstat(fd, &st) != 0) {
+			::close(fd);
+			throw FileError("Can't get the size of file \"" + filename + "\"!");
+		}
+		mSize = (size_t)st.st_size;
+
+		if (mSize == 0) {
+			::close(fd);
+			mData = empty;
+			return;
+		}
+		void* addr = mmap(nullptr, mSize, PROT_READ, MAP_SHARED, fd, 0);
+		::close(fd);// The mapping stays valid after closing the descriptor
+		if (addr == MAP_FAILED) {
+			mSize = 0;
+			throw FileError("Can't map file \"" + filename + "\"!");
+		}
+		mData = (const char*)addr;
+#endif
+	}
+
+	// Unmaps the file. Pointers to the mapped data become invalid.
+	void close() noexcept {
+#ifdef _WIN32
+		if (mData && mMapping != NULL)
+			UnmapViewOfFile(mData);
+		if (mMapping != NULL)
+			CloseHandle(mMapping);
+		if (mFile != INVALID_HANDLE_VALUE)
+			CloseHandle(mFile);
+		mMapping = NULL;
+		mFile = INVALID_HANDLE_VALUE;
+#else
+		if (mData && mSize)
+			munmap((void*)mData, mSize);
+#endif
+		mData = nullptr;
+		mSize = 0;
+	}
+
+	bool isOpen() const noexcept {
+		return mData != nullptr;
+	}
+
+	const char* data() const noexcept {
+		return mData;
+	}
+
+	size_t size() const noexcept {
+		return mSize;
+	}
+};
+
+#endif
@@ -9,35 +9,1708 @@ Part of my MUtilize repo: https://github.com/LegendaryMauricius/MUtilize
 #define _MIINI_H
 
 #include <string.h>
+#include <string>
+#include <string_view>
+#include <optional>
 #include <map>
+#include <set>
+#include <unordered_map>
+#include <unordered_set>
+#include <memory>
+#include <memory_resource>
+#include <vector>
+#include <algorithm>
+#include <utility>
+#include <tuple>
 #include <istream>
 #include <fstream>
+#include <filesystem>
 #include <sstream>
+#include <charconv>
+#include <type_traits>
+#include <cstdint>
 #include <stdexcept>
+#include <mutex>
+#include <atomic>
+#include <cstdlib>
+#include <exception>
+#include <thread>
+#include "MappedFile.h"
+
+class MiIniView;
+template<class _StringT>
+class MiIniLayered;
+struct MiIniStaticParser;
+template<class _IniT>
+class MiIniProperties;
+
+/*
+A map stored as a vector of key-value pairs sorted by key. Used by MiIniFlatStorage.
+Lookups are binary searches over contiguous memory and accept any key type comparable with _KeyT.
+Inserting a new key moves all the following elements, so the map is meant to be filled once and then mostly read.
+For bulk filling, append the elements with appendUnsorted() and call sortUnique() once all of them are added.
+*/
+template<class _KeyT, class _ValueT>
+class MiIniFlatMap
+{
+public:
+	using key_type			= _KeyT;
+	using mapped_type		= _ValueT;
+	using value_type		= std::pair<_KeyT, _ValueT>;
+	using size_type			= size_t;
+	using iterator			= typename std::vector<value_type>::iterator;
+	using const_iterator	= typename std::vector<value_type>::const_iterator;
+
+private:
+	std::vector<value_type> mElements;
+	size_t mSortedCount;// The elements after this were added by appendUnsorted()
+
+	template<class _K>
+	iterator lowerBound(const _K& key) {
+		return std::lower_bound(mElements.begin(), mElements.begin() + mSortedCount, key,
+			[](const value_type& e, const _K& k) { return e.first < k; });
+	}
+
+	template<class _K>
+	const_iterator lowerBound(const _K& key) const {
+		return std::lower_bound(mElements.begin(), mElements.begin() + mSortedCount, key,
+			[](const value_type& e, const _K& k) { return e.first < k; });
+	}
+
+public:
+	MiIniFlatMap() : mSortedCount(0) {}
+
+	iterator begin() noexcept { return mElements.begin(); }
+	iterator end() noexcept { return mElements.end(); }
+	const_iterator begin() const noexcept { return mElements.begin(); }
+	const_iterator end() const noexcept { return mElements.end(); }
+
+	size_t size() const noexcept { return mElements.size(); }
+	bool empty() const noexcept { return mElements.empty(); }
+
+	void clear() noexcept {
+		mElements.clear();
+		mSortedCount = 0;
+	}
+
+	void reserve(size_t count) {
+		mElements.reserve(count);
+	}
+
+	template<class _K>
+	iterator find(const _K& key) {
+		auto it = lowerBound(key);
+		return (it != mElements.begin() + mSortedCount && it->first == key) ? it : end();
+	}
+
+	template<class _K>
+	const_iterator find(const _K& key) const {
+		auto it = lowerBound(key);
+		return (it != mElements.begin() + mSortedCount && it->first == key) ? it : end();
+	}
+
+	template<class _K>
+	size_t count(const _K& key) const {
+		return find(key) != end();
+	}
+
+	template<class... _Args>
+	std::pair<iterator, bool> try_emplace(_KeyT key, _Args&&... args) {
+		auto it = lowerBound(key);
+		if (it != mElements.begin() + mSortedCount && it->first == key)
+			return std::make_pair(it, false);
+		it = mElements.emplace(it, std::piecewise_construct,
+			std::forward_as_tuple(std::move(key)), std::forward_as_tuple(std::forward<_Args>(args)...));
+		mSortedCount++;
+		return std::make_pair(it, true);
+	}
+
+	template<class _M>
+	std::pair<iterator, bool> insert_or_assign(_KeyT key, _M&& val) {
+		auto res = try_emplace(std::move(key));
+		res.first->second = std::forward<_M>(val);
+		return res;
+	}
+
+	std::pair<iterator, bool> insert(value_type val) {
+		return try_emplace(std::move(val.first), std::move(val.second));
+	}
+
+	_ValueT& operator[](_KeyT key) {
+		return try_emplace(std::move(key)).first->second;
+	}
+
+	template<class _K>
+	size_t erase(const _K& key) {
+		auto it = find(key);
+		if (it == end())
+			return 0;
+		erase(it);
+		return 1;
+	}
+
+	iterator erase(const_iterator it) {
+		if ((size_t)(it - mElements.cbegin()) < mSortedCount)
+			mSortedCount--;
+		return mElements.erase(it);
+	}
+
+	/*
+	Appends the element without keeping the order.
+	Lookups don't see appended elements until sortUnique() is called.
+	*/
+	void appendUnsorted(_KeyT key, _ValueT val) {
+		mElements.emplace_back(std::move(key), std::move(val));
+	}
+
+	// Sorts the appended elements into the map. For duplicate keys the last appended value is kept.
+	void sortUnique() {
+		if (mSortedCount == mElements.size())
+			return;
+
+		auto keyLess = [](const value_type& a, const value_type& b) { return a.first < b.first; };
+		std::stable_sort(mElements.begin() + mSortedCount, mElements.end(), keyLess);
+		std::inplace_merge(mElements.begin(), mElements.begin() + mSortedCount, mElements.end(), keyLess);
+
+		auto out = mElements.begin();
+		for (auto it = mElements.begin(); it != mElements.end(); ++it) {
+			auto next = it + 1;
+			if (next != mElements.end() && next->first == it->first)
+				continue;
+			if (out != it)
+				*out = std::move(*it);
+			++out;
+		}
+		mElements.erase(out, mElements.end());
+		mSortedCount = mElements.size();
+	}
+
+	/*
+	Moves the elements of other whose keys aren't in this map into it, like std::map::merge().
+	The elements with keys that already exist stay in other.
+	*/
+	void merge(MiIniFlatMap& other) {
+		sortUnique();
+		other.sortUnique();
+		if (mElements.empty()) {
+			mElements.swap(other.mElements);
+			std::swap(mSortedCount, other.mSortedCount);
+			return;
+		}
+
+		std::vector<value_type> merged, rest;
+		merged.reserve(mElements.size() + other.mElements.size());
+		auto a = mElements.begin();
+		auto b = other.mElements.begin();
+		while (a != mElements.end() || b != other.mElements.end()) {
+			if (b == other.mElements.end() || (a != mElements.end() && a->first < b->first)) {
+				merged.push_back(std::move(*a++));
+			}
+			else if (a == mElements.end() || b->first < a->first) {
+				merged.push_back(std::move(*b++));
+			}
+			else {
+				merged.push_back(std::move(*a++));
+				rest.push_back(std::move(*b++));
+			}
+		}
+		mElements.swap(merged);
+		mSortedCount = mElements.size();
+		other.mElements.swap(rest);
+		other.mSortedCount = other.mElements.size();
+	}
+
+	bool operator==(const MiIniFlatMap& other) const {
+		return mElements == other.mElements;
+	}
+
+	bool operator!=(const MiIniFlatMap& other) const {
+		return mElements != other.mElements;
+	}
+};
+
+/*
+A string interned in a MiIniArena. Interned strings with the same content are the same object,
+so comparing two atoms from the same arena and hashing them only needs their address.
+Comparisons with other strings compare the content.
+The atom is a single pointer to the null-terminated string, which is preceded by its size in the arena.
+*/
+template<class _CharT>
+class MiIniAtom
+{
+public:
+	using StringView = std::basic_string_view<_CharT>;
+
+private:
+	const _CharT* mData;
+
+public:
+	// data has to be created by MiIniArena::intern()
+	explicit MiIniAtom(const _CharT* data) noexcept :
+		mData(data)
+	{}
+
+	const _CharT* data() const noexcept { return mData; }
+	size_t size() const noexcept { return ((const size_t*)mData)[-1]; }
+	StringView view() const noexcept { return StringView(mData, size()); }
+	operator StringView() const noexcept { return view(); }
+
+	friend bool operator==(const MiIniAtom& a, const MiIniAtom& b) noexcept {
+		return a.mData == b.mData;
+	}
+
+	friend bool operator==(const MiIniAtom& a, StringView b) noexcept {
+		return a.view() == b;
+	}
+
+	template<class _TraitsT>
+	friend std::basic_ostream<_CharT, _TraitsT>& operator<<(std::basic_ostream<_CharT, _TraitsT>& os, const MiIniAtom& a) {
+		return os << a.view();
+	}
+
+	struct Hash {
+		size_t operator()(const MiIniAtom& a) const noexcept {
+			return std::hash<const _CharT*>()(a.mData);
+		}
+	};
+};
+
+/*
+The memory of MiIniArenaStorage. Allocations are carved out of big blocks,
+which are all freed at once when the arena is destroyed, and deallocating does nothing.
+The blocks grow up to maxBlockSize, so at most one block's worth of memory is left unused.
+Also interns the keys and section names, storing each unique string only once.
+Lookups with find() don't allocate, so they are safe to do from multiple threads.
+*/
+template<class _CharT>
+class MiIniArena : public std::pmr::memory_resource
+{
+public:
+	using StringView = std::basic_string_view<_CharT>;
+	using Atom = MiIniAtom<_CharT>;
+
+	static constexpr size_t firstBlockSize = 4096;
+	static constexpr size_t maxBlockSize = 1 << 20;
+
+private:
+	std::vector<std::unique_ptr<std::byte[]> > mBlocks;
+	std::byte* mCurrent;
+	size_t mLeft;
+	size_t mNextBlockSize;
+	std::pmr::unordered_set<StringView> mAtoms;
+
+	void* do_allocate(size_t bytes, size_t alignment) override {
+		size_t pad = (alignment - (uintptr_t)mCurrent % alignment) % alignment;
+		if (pad + bytes > mLeft) {
+			size_t size = std::max(bytes + alignment, mNextBlockSize);
+			mBlocks.emplace_back(new std::byte[size]);
+			mCurrent = mBlocks.back().get();
+			mLeft = size;
+			mNextBlockSize = std::min(mNextBlockSize * 2, maxBlockSize);
+			pad = (alignment - (uintptr_t)mCurrent % alignment) % alignment;
+		}
+
+		void* p = mCurrent + pad;
+		mCurrent += pad + bytes;
+		mLeft -= pad + bytes;
+		return p;
+	}
+
+	void do_deallocate(void*, size_t, size_t) override {}
+
+	bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+		return this == &other;
+	}
+
+public:
+	MiIniArena() :
+		mCurrent(nullptr),
+		mLeft(0),
+		mNextBlockSize(firstBlockSize),
+		mAtoms(this)
+	{}
+
+	MiIniArena(const MiIniArena&) = delete;
+	MiIniArena& operator=(const MiIniArena&) = delete;
+
+	// Returns the interned string with the content of str, interning it if needed
+	Atom intern(StringView str) {
+		auto it = mAtoms.find(str);
+		if (it == mAtoms.end()) {
+			size_t* block = (size_t*)allocate(sizeof(size_t) + (str.size() + 1) * sizeof(_CharT), alignof(size_t));
+			*block = str.size();
+			_CharT* data = (_CharT*)(block + 1);
+			std::copy(str.begin(), str.end(), data);
+			data[str.size()] = _CharT();
+			it = mAtoms.insert(StringView(data, str.size())).first;
+		}
+		return Atom(it->data());
+	}
+
+	// Returns the interned string with the content of str, if it was interned
+	std::optional<Atom> find(StringView str) const {
+		auto it = mAtoms.find(str);
+		if (it == mAtoms.end())
+			return std::nullopt;
+		return Atom(it->data());
+	}
+};
+
+template<class _CharT, class _ValueT>
+class MiIniAtomMap;
+
+template<class _T>
+struct _MiIniIsAtomMap : std::false_type {};
+template<class _CharT, class _ValueT>
+struct _MiIniIsAtomMap<MiIniAtomMap<_CharT, _ValueT> > : std::true_type {};
+
+/*
+A hash map keyed by strings interned in a MiIniArena, which also holds its elements. Used by MiIniArenaStorage.
+The keys are looked up by content, but once found they are hashed and compared by their address.
+Values that use a polymorphic allocator, such as std::pmr::string and nested MiIniAtomMaps, are allocated in the arena too.
+The map doesn't own the arena, and is created by its owner (see MiIniArenaMap) with the arena as the allocator.
+*/
+template<class _CharT, class _ValueT>
+class MiIniAtomMap
+{
+public:
+	using StringView		= std::basic_string_view<_CharT>;
+	using key_type			= MiIniAtom<_CharT>;
+	using mapped_type		= _ValueT;
+	using allocator_type	= std::pmr::polymorphic_allocator<std::byte>;
+
+private:
+	using _MapT = std::pmr::unordered_map<key_type, _ValueT, typename key_type::Hash>;
+
+	MiIniArena<_CharT>* mArena;
+	_MapT mMap;
+
+public:
+	using value_type		= typename _MapT::value_type;
+	using iterator			= typename _MapT::iterator;
+	using const_iterator	= typename _MapT::const_iterator;
+	using size_type			= size_t;
+
+	// The allocator's resource has to be a MiIniArena<_CharT>
+	explicit MiIniAtomMap(const allocator_type& alloc) :
+		mArena(static_cast<MiIniArena<_CharT>*>(alloc.resource())),
+		mMap(alloc)
+	{}
+
+	MiIniAtomMap(const MiIniAtomMap&) = delete;
+	MiIniAtomMap& operator=(const MiIniAtomMap&) = delete;
+
+	iterator begin() noexcept { return mMap.begin(); }
+	iterator end() noexcept { return mMap.end(); }
+	const_iterator begin() const noexcept { return mMap.begin(); }
+	const_iterator end() const noexcept { return mMap.end(); }
+
+	size_t size() const noexcept { return mMap.size(); }
+	bool empty() const noexcept { return mMap.empty(); }
+
+	// Removes the elements. The memory stays reserved in the arena.
+	void clear() noexcept {
+		mMap.clear();
+	}
+
+	iterator find(StringView key) {
+		auto atom = mArena->find(key);
+		return atom ? mMap.find(*atom) : mMap.end();
+	}
+
+	const_iterator find(StringView key) const {
+		auto atom = mArena->find(key);
+		return atom ? mMap.find(*atom) : mMap.end();
+	}
+
+	size_t count(StringView key) const {
+		return find(key) != end();
+	}
+
+	template<class... _Args>
+	std::pair<iterator, bool> try_emplace(StringView key, _Args&&... args) {
+		return mMap.try_emplace(mArena->intern(key), std::forward<_Args>(args)...);
+	}
+
+	template<class _M>
+	std::pair<iterator, bool> insert_or_assign(StringView key, _M&& val) {
+		return mMap.insert_or_assign(mArena->intern(key), std::forward<_M>(val));
+	}
+
+	_ValueT& operator[](StringView key) {
+		return try_emplace(key).first->second;
+	}
+
+	size_t erase(StringView key) {
+		auto atom = mArena->find(key);
+		return atom ? mMap.erase(*atom) : 0;
+	}
+
+	iterator erase(const_iterator it) {
+		return mMap.erase(it);
+	}
+
+	/*
+	Copies the elements of other whose keys aren't in this map, interning the keys in this map's arena.
+	Nested maps that exist in both are combined the same way.
+	*/
+	void insertMissing(const MiIniAtomMap& other) {
+		for (auto& elem : other) {
+			if constexpr (_MiIniIsAtomMap<_ValueT>::value) {
+				(*this)[elem.first].insertMissing(elem.second);
+			}
+			else {
+				try_emplace(elem.first, elem.second);
+			}
+		}
+	}
+
+	bool operator==(const MiIniAtomMap& other) const {
+		if (size() != other.size())
+			return false;
+		for (auto& elem : *this) {
+			auto it = other.find(elem.first);
+			if (it == other.end() || !(it->second == elem.second))
+				return false;
+		}
+		return true;
+	}
+
+	bool operator!=(const MiIniAtomMap& other) const {
+		return !(*this == other);
+	}
+};
+
+/*
+A MiIniAtomMap that owns its MiIniArena. Used as the data map of MiIniArenaStorage.
+clear() frees the whole arena at once. Moving the map moves the arena, while copying it copies the content into a new arena.
+*/
+template<class _CharT, class _ValueT>
+class MiIniArenaMap
+{
+private:
+	using _MapT = MiIniAtomMap<_CharT, _ValueT>;
+
+	struct State {
+		MiIniArena<_CharT> arena;
+		_MapT map;
+
+		State() :
+			map(&arena)
+		{}
+	};
+
+	std::unique_ptr<State> mState;
+
+public:
+	using StringView		= std::basic_string_view<_CharT>;
+	using key_type			= typename _MapT::key_type;
+	using mapped_type		= _ValueT;
+	using value_type		= typename _MapT::value_type;
+	using iterator			= typename _MapT::iterator;
+	using const_iterator	= typename _MapT::const_iterator;
+	using size_type			= size_t;
+
+	MiIniArenaMap() :
+		mState(new State())
+	{}
+
+	MiIniArenaMap(const MiIniArenaMap& other) :
+		MiIniArenaMap()
+	{
+		mState->map.insertMissing(other.mState->map);
+	}
+
+	MiIniArenaMap(MiIniArenaMap&& other) :
+		MiIniArenaMap()
+	{
+		mState.swap(other.mState);
+	}
+
+	MiIniArenaMap& operator=(const MiIniArenaMap& other) {
+		MiIniArenaMap tmp(other);
+		mState.swap(tmp.mState);
+		return *this;
+	}
+
+	MiIniArenaMap& operator=(MiIniArenaMap&& other) noexcept {
+		mState.swap(other.mState);
+		return *this;
+	}
+
+	// The arena holding the content
+	MiIniArena<_CharT>& arena() noexcept { return mState->arena; }
+
+	iterator begin() noexcept { return mState->map.begin(); }
+	iterator end() noexcept { return mState->map.end(); }
+	const_iterator begin() const noexcept { return mState->map.begin(); }
+	const_iterator end() const noexcept { return mState->map.end(); }
+
+	size_t size() const noexcept { return mState->map.size(); }
+	bool empty() const noexcept { return mState->map.empty(); }
+
+	// Removes the elements and frees the arena
+	void clear() {
+		mState.reset(new State());
+	}
+
+	iterator find(StringView key) { return mState->map.find(key); }
+	const_iterator find(StringView key) const { return mState->map.find(key); }
+	size_t count(StringView key) const { return mState->map.count(key); }
+
+	template<class... _Args>
+	std::pair<iterator, bool> try_emplace(StringView key, _Args&&... args) {
+		return mState->map.try_emplace(key, std::forward<_Args>(args)...);
+	}
+
+	template<class _M>
+	std::pair<iterator, bool> insert_or_assign(StringView key, _M&& val) {
+		return mState->map.insert_or_assign(key, std::forward<_M>(val));
+	}
+
+	_ValueT& operator[](StringView key) { return mState->map[key]; }
+	size_t erase(StringView key) { return mState->map.erase(key); }
+	iterator erase(const_iterator it) { return mState->map.erase(it); }
+
+	// Copies the content of other that isn't in this map, like MiIniAtomMap::insertMissing()
+	void insertMissing(const MiIniArenaMap& other) {
+		mState->map.insertMissing(other.mState->map);
+	}
+
+	bool operator==(const MiIniArenaMap& other) const {
+		return mState->map == other.mState->map;
+	}
+
+	bool operator!=(const MiIniArenaMap& other) const {
+		return mState->map != other.mState->map;
+	}
+};
+
+/*
+Storage backends for MiIni::dataMap.
+A backend specifies the section map (key -> value) and the data map (section -> section map) types for a string type,
+which need to support the usual map interface with heterogeneous find(), and how readMore() stores the values.
+*/
+
+// Ordered std::map storage. This is the default. Sections and keys are written in sorted order.
+struct MiIniMapStorage {
+	template<class _StringT>
+	using SectionMap = std::map<_StringT, _StringT, std::less<> >;
+	template<class _StringT>
+	using DataMap = std::map<_StringT, SectionMap<_StringT>, std::less<> >;
+
+	// Stores a value read by readMore()
+	template<class _SectionMapT, class _StringViewT>
+	static void load(_SectionMapT& sect, _StringViewT key, _StringViewT val) {
+		sect[typename _SectionMapT::key_type(key)].assign(val.data(), val.size());
+	}
+
+	// Called once readMore() is done
+	template<class _DataMapT>
+	static void finishLoad(_DataMapT&) {}
+
+	/*
+	Moves the sections and values of from that into doesn't have into it. The values that exist in both stay in from.
+	Used by readMoreParallel() to combine the separately parsed parts of the text.
+	*/
+	template<class _DataMapT>
+	static void merge(_DataMapT& into, _DataMapT& from) {
+		into.merge(from);
+		for (auto& sect : from) {
+			into.find(sect.first)->second.merge(sect.second);
+		}
+	}
+};
+
+// Hashed std::unordered_map storage. Sections and keys are written in an unspecified order.
+struct MiIniHashStorage {
+	template<class _StringT>
+	struct Hash {
+		using is_transparent = void;
+		size_t operator()(std::basic_string_view<typename _StringT::value_type> s) const {
+			return std::hash<std::basic_string_view<typename _StringT::value_type> >()(s);
+		}
+	};
+
+	template<class _StringT>
+	using SectionMap = std::unordered_map<_StringT, _StringT, Hash<_StringT>, std::equal_to<> >;
+	template<class _StringT>
+	using DataMap = std::unordered_map<_StringT, SectionMap<_StringT>, Hash<_StringT>, std::equal_to<> >;
+
+	template<class _SectionMapT, class _StringViewT>
+	static void load(_SectionMapT& sect, _StringViewT key, _StringViewT val) {
+		MiIniMapStorage::load(sect, key, val);
+	}
+
+	template<class _DataMapT>
+	static void finishLoad(_DataMapT&) {}
+
+	template<class _DataMapT>
+	static void merge(_DataMapT& into, _DataMapT& from) {
+		MiIniMapStorage::merge(into, from);
+	}
+};
+
+/*
+Flat sorted-vector storage, for configurations that are loaded once and then read a lot.
+readMore() appends the values unsorted and sorts each section once at the end,
+after which lookups are cache-friendly binary searches. Sections and keys are written in sorted order.
+*/
+struct MiIniFlatStorage {
+	template<class _StringT>
+	using SectionMap = MiIniFlatMap<_StringT, _StringT>;
+	template<class _StringT>
+	using DataMap = MiIniFlatMap<_StringT, SectionMap<_StringT> >;
+
+	template<class _SectionMapT, class _StringViewT>
+	static void load(_SectionMapT& sect, _StringViewT key, _StringViewT val) {
+		using _StringT = typename _SectionMapT::key_type;
+		sect.appendUnsorted(_StringT(key), _StringT(val));
+	}
+
+	template<class _DataMapT>
+	static void finishLoad(_DataMapT& data) {
+		for (auto& sect : data) {
+			sect.second.sortUnique();
+		}
+	}
+
+	template<class _DataMapT>
+	static void merge(_DataMapT& into, _DataMapT& from) {
+		MiIniMapStorage::merge(into, from);
+	}
+};
+
+/*
+Arena storage, for big configurations where allocating every key and value separately costs too much time and memory.
+The content is stored in a MiIniArena owned by dataMap, in a few big blocks that are freed together by clear(), read() or close().
+Section names and keys are interned, so each unique name is stored once, and the maps hash and compare them by address.
+Values are stored in the arena if the string type uses a polymorphic allocator, e.g. MiIni<std::pmr::string, MiIniArenaStorage>.
+Since the arena never reuses memory, replaced and erased values stay allocated until the arena is freed.
+Sections and keys are written in an unspecified order.
+*/
+struct MiIniArenaStorage {
+	template<class _StringT>
+	using SectionMap = MiIniAtomMap<typename _StringT::value_type, _StringT>;
+	template<class _StringT>
+	using DataMap = MiIniArenaMap<typename _StringT::value_type, SectionMap<_StringT> >;
+
+	template<class _SectionMapT, class _StringViewT>
+	static void load(_SectionMapT& sect, _StringViewT key, _StringViewT val) {
+		sect[key].assign(val.data(), val.size());
+	}
+
+	template<class _DataMapT>
+	static void finishLoad(_DataMapT&) {}
+
+	// Copies the content, since the interned strings of from are in a different arena. from is cleared.
+	template<class _DataMapT>
+	static void merge(_DataMapT& into, _DataMapT& from) {
+		into.insertMissing(from);
+		from.clear();
+	}
+};
 
 /*
 A simple class for ini files.
 The template allows you to specify the type used as a string, as well as the string, input, output and file stream types.
 Default is std::string.
+The storage of dataMap can be chosen with _StorageT. See MiIniMapStorage, MiIniHashStorage, MiIniFlatStorage and MiIniArenaStorage.
+
+Thread safety: const methods never modify the MiIni and never allocate for lookups,
+so any number of threads can call them concurrently on a shared MiIni without locking,
+as long as no thread modifies it at the same time.
+Note that getStr() and get() aren't const, since they insert the default value on a miss. Use find(), tryGet() or getOr() instead.
+With interpolation enabled (see enableInterpolation()), the first lookup of an interpolated value expands and caches it
+under an internal lock, which is the only case where a const lookup allocates.
 */
 template<
-	class _StringT = std::string >
+	class _StringT = std::string,
+	class _StorageT = MiIniMapStorage >
 class MiIni
 {
 public:
+	using _CharT = typename _StringT::value_type;
+	using _StringViewT = std::basic_string_view<typename _StringT::value_type>;
 	using _SStreamT = std::basic_stringstream<typename _StringT::value_type>;
 	using _IStreamT = std::basic_istream<typename _StringT::value_type>;
 	using _OStreamT = std::basic_ostream<typename _StringT::value_type>;
 	using _FStreamT = std::basic_fstream<typename _StringT::value_type>;
+	using Char			= _CharT;
 	using String		= _StringT;
+	using StringView	= _StringViewT;
 	using StringStream	= _SStreamT;
 	using InputStream	= _IStreamT;
 	using OutputStream	= _OStreamT;
 	using FileStream	= _FStreamT;
+	using Storage		= _StorageT;
+	using SectionMap	= typename _StorageT::template SectionMap<_StringT>;
+	using DataMap		= typename _StorageT::template DataMap<_StringT>;
+
+private:
+	friend class MiIniView;
+	template<class> friend class MiIniLayered;
+	friend struct MiIniStaticParser;
+	template<class> friend class MiIniProperties;
+
+	String mFilename;
+	bool mAutoSync;
+	size_t mGeneration;// Changes whenever keys are added or removed, which can move the stored values
+	size_t mRevision;// Changes on every modification
+	bool mDirtyTracking;
+	// The dirty state is mutable only so that sync(), which is const, can mark the content clean after writing it
+	mutable bool mAllDirty;// Whether the content may differ from the linked file in unrecorded ways
+	mutable std::set<std::pair<String, String>, std::less<> > mDirtyKeys;
+
+	template<class _V>
+	using _NameMap = std::map<String, _V, std::less<> >;
+
+	struct Expansion {
+		String value;
+		std::atomic<bool> valid{ false };// Set after the value is written, so it can be checked without locking
+		bool expanding = false;// Used to detect cycles
+	};
+
+	/*
+	An open addressing table from the addresses of the stored values to their expansions, which is probed without locking.
+	Slots are only filled under the cache's mutex, and never change afterwards, except for being dropped with the whole table.
+	*/
+	struct ExpansionIndex {
+		struct Slot {
+			std::atomic<const String*> raw{ nullptr };
+			std::atomic<Expansion*> expansion{ nullptr };// Written before raw
+		};
+
+		std::unique_ptr<Slot[]> slots;
+		size_t mask;
+		size_t used;
+
+		explicit ExpansionIndex(size_t capacity) : slots(new Slot[capacity]), mask(capacity - 1), used(0) {}
+
+		static size_t slotOf(const String* raw) {
+			return (size_t)((uintptr_t)raw / alignof(String) * 0x9E3779B97F4A7C15ull);
+		}
+
+		Expansion* find(const String* raw) const {
+			for (size_t i = slotOf(raw) & mask;; i = (i + 1) & mask) {
+				const String* r = slots[i].raw.load(std::memory_order_acquire);
+				if (r == raw)
+					return slots[i].expansion.load(std::memory_order_relaxed);
+				if (!r)
+					return nullptr;
+			}
+		}
+
+		void insert(const String* raw, Expansion* exp) {
+			size_t i = slotOf(raw) & mask;
+			while (slots[i].raw.load(std::memory_order_relaxed))
+				i = (i + 1) & mask;
+			slots[i].expansion.store(exp, std::memory_order_relaxed);
+			slots[i].raw.store(raw, std::memory_order_release);
+			used++;
+		}
+	};
+
+	/*
+	The expanded values of interpolated keys and the keys they reference, used by find() when interpolation is enabled.
+	Entries aren't erased when they are invalidated, so pointers to their values stay valid.
+	The index finds a valid expansion from the stored value without locking, so reading it costs about as much as a plain value.
+	It's dropped whenever keys or sections are added or removed, since that can move the stored values,
+	but the expansions stay, so refilling it doesn't expand anything again.
+	Copying the cache creates an empty one, since the copy can be refilled when needed.
+	*/
+	struct ExpansionCache {
+		std::mutex mutex;
+		_NameMap<_NameMap<Expansion> > expansions;
+		_NameMap<_NameMap<std::vector<std::pair<StringView, StringView> > > > dependents;// Referenced key -> keys of the expansions using it
+		std::atomic<ExpansionIndex*> index{ nullptr };
+		std::vector<std::unique_ptr<ExpansionIndex> > indices;// The current index and the ones it replaced, which readers may still be probing
+
+		ExpansionCache() {}
+		ExpansionCache(const ExpansionCache&) {}
+		ExpansionCache& operator=(const ExpansionCache&) { clear(); return *this; }
+
+		void clear() {
+			clearIndex();
+			expansions.clear();
+			dependents.clear();
+		}
+
+		// Only called while modifying the MiIni, when nothing can be reading the index
+		void clearIndex() {
+			index.store(nullptr, std::memory_order_relaxed);
+			indices.clear();
+		}
+
+		// Returns the expansion of the stored value if it's indexed. Doesn't need the mutex.
+		Expansion* find(const String* raw) const {
+			ExpansionIndex* idx = index.load(std::memory_order_acquire);
+			return idx ? idx->find(raw) : nullptr;
+		}
+
+		// Adds the expansion to the index, growing it into a new table when it's half full. Needs the mutex to be locked.
+		void addToIndex(const String* raw, Expansion* exp) {
+			ExpansionIndex* idx = index.load(std::memory_order_relaxed);
+			if (idx && idx->find(raw))
+				return;
+			if (!idx || (idx->used + 1) * 2 > idx->mask + 1) {
+				auto grown = std::make_unique<ExpansionIndex>(idx ? (idx->mask + 1) * 2 : 16);
+				if (idx) {
+					for (size_t i = 0; i <= idx->mask; i++) {
+						const String* r = idx->slots[i].raw.load(std::memory_order_relaxed);
+						if (r)
+							grown->insert(r, idx->slots[i].expansion.load(std::memory_order_relaxed));
+					}
+				}
+				idx = grown.get();
+				indices.push_back(std::move(grown));
+				idx->insert(raw, exp);
+				index.store(idx, std::memory_order_release);
+				return;
+			}
+			idx->insert(raw, exp);
+		}
+
+		// Invalidates the expansion of the key and of all the keys that reference it, directly or indirectly
+		void invalidate(StringView sect, StringView key) {
+			std::vector<std::pair<StringView, StringView> > pending{ { sect, key } };
+			bool first = true;
+			while (pending.size()) {
+				auto name = pending.back();
+				pending.pop_back();
+
+				auto sit = expansions.find(name.first);
+				if (sit != expansions.end()) {
+					auto it = sit->second.find(name.second);
+					if (it != sit->second.end()) {
+						// An invalid expansion's dependents were already invalidated along with it
+						if (!it->second.valid.load(std::memory_order_relaxed) && !first)
+							continue;
+						it->second.valid.store(false, std::memory_order_relaxed);
+					}
+				}
+				first = false;
+
+				auto dsit = dependents.find(name.first);
+				if (dsit != dependents.end()) {
+					auto dit = dsit->second.find(name.second);
+					if (dit != dsit->second.end())
+						pending.insert(pending.end(), dit->second.begin(), dit->second.end());
+				}
+			}
+		}
+	};
+
+	bool mInterpolate;
+	bool mValidateUtf8;
+	mutable ExpansionCache mExpansionCache;
+
+	void touch(bool structural) {
+		mRevision++;
+		if (structural)
+			mGeneration++;
+		if (mInterpolate)
+			mExpansionCache.clear();
+	}
+
+	// Called after inserting an empty section, which can move the stored values, but can't change any expansion
+	void touchSection() {
+		mRevision++;
+		mGeneration++;
+		if (mInterpolate)
+			mExpansionCache.clearIndex();
+	}
+
+	// Empties a moved-from MiIni and unlinks it, invalidating the Keys bound to it
+	void releaseContent() {
+		dataMap.clear();
+		mDirtyKeys.clear();
+		mExpansionCache.clear();
+		mFilename = String();
+		mAutoSync = false;
+		mAllDirty = false;
+		mRevision++;
+		mGeneration++;
+	}
+
+	// Records the modified key when dirty tracking is enabled
+	void touch(bool structural, StringView sect, StringView key) {
+		mRevision++;
+		if (structural)
+			mGeneration++;
+		if (mInterpolate) {
+			if (structural)
+				mExpansionCache.clearIndex();
+			mExpansionCache.invalidate(sect, key);
+		}
+
+		if (mDirtyTracking)
+			mDirtyKeys.emplace(String(sect), String(key));
+		else
+			mAllDirty = true;
+	}
+
+	void markClean() const {
+		mAllDirty = false;
+		mDirtyKeys.clear();
+	}
+
+	static constexpr bool isSpace(Char c) {
+		return c == Char(' ') || c == Char('\t') || c == Char('\r') || c == Char('\n');
+	}
+
+	static constexpr StringView trimLeft(StringView s) {
+		size_t b = 0;
+		while (b < s.size() && isSpace(s[b])) b++;
+		return s.substr(b);
+	}
+
+	static constexpr StringView trimRight(StringView s) {
+		size_t e = s.size();
+		while (e && isSpace(s[e - 1])) e--;
+		return s.substr(0, e);
+	}
+
+	enum class LineKind { Empty, Section, KeyValue, Invalid };
+
+public:
+	// What a parse() callback wants the parser to do next
+	enum class ParseAction { Continue, SkipSection, Stop };
+
+private:
+
+	/*
+	Splits a single line (without its line terminator) into its parts, without copying.
+	For a section header, first is the section name. For a key-value pair, first is the key and second the value.
+	*/
+	static constexpr LineKind tokenizeLine(StringView ln, StringView& first, StringView& second) {
+		ln = trimRight(trimLeft(ln));
+		size_t commentPos = ln.find(Char('#'));
+		if (commentPos != StringView::npos) {
+			ln = ln.substr(0, commentPos);
+		}
+
+		if (ln.empty()) {
+			return LineKind::Empty;
+		}
+		if (ln[0] == Char('[')) {
+			first = trimRight(trimLeft(ln.substr(1, ln.find(Char(']')) - 1)));
+			return LineKind::Section;
+		}
+
+		size_t eqpos = ln.find(Char('='));
+		if (eqpos == StringView::npos) {
+			return LineKind::Invalid;
+		}
+		first = trimRight(ln.substr(0, eqpos));
+		second = trimLeft(ln.substr(eqpos + 1));
+		return LineKind::KeyValue;
+	}
+
+	// Arithmetic types that are converted with from_chars and to_chars instead of a StringStream
+	template<class _T>
+	static constexpr bool isCharsConvertible =
+		std::is_arithmetic<_T>::value && !std::is_same<_T, bool>::value &&
+		!std::is_same<_T, char>::value && !std::is_same<_T, signed char>::value && !std::is_same<_T, unsigned char>::value &&
+		!std::is_same<_T, wchar_t>::value && !std::is_same<_T, char8_t>::value &&
+		!std::is_same<_T, char16_t>::value && !std::is_same<_T, char32_t>::value;
+
+	// The number type that enums are converted through, wide enough even for char underlying types
+	template<class _T>
+	using _EnumNumberT = std::conditional_t<std::is_signed<std::underlying_type_t<_T> >::value, long long, unsigned long long>;
+
+	static bool equalsAscii(StringView str, const char* ascii) {
+		size_t i = 0;
+		for (; i < str.size() && ascii[i]; i++) {
+			if (str[i] != Char(ascii[i]))
+				return false;
+		}
+		return i == str.size() && !ascii[i];
+	}
+
+	/*
+	Converts the stored value to _T.
+	Numbers and booleans are parsed without allocating. Booleans accept 1, 0, true and false.
+	Enums are parsed as numbers of their underlying type.
+	Other types are streamed from a StringStream. Values that can't be parsed result in _T().
+	*/
+	template<class _T>
+	static _T fromString(StringView str) {
+		if constexpr (std::is_same<_T, bool>::value) {
+			str = trimRight(str);
+			return equalsAscii(str, "1") || equalsAscii(str, "true");
+		}
+		else if constexpr (std::is_enum<_T>::value) {
+			return (_T)fromString<_EnumNumberT<_T> >(str);
+		}
+		else if constexpr (isCharsConvertible<_T>) {
+			if (str.size() > 1 && str[0] == Char('+') && str[1] != Char('-'))
+				str.remove_prefix(1);
+
+			_T ret = _T();
+			if constexpr (std::is_same<Char, char>::value) {
+				std::from_chars(str.data(), str.data() + str.size(), ret);
+			}
+			else {
+				// Numbers are ASCII, so they can be narrowed before parsing
+				char buf[128];
+				size_t len = 0;
+				while (len < str.size() && len < sizeof(buf) && str[len] > 0 && str[len] < 128) {
+					buf[len] = (char)str[len];
+					len++;
+				}
+				std::from_chars(buf, buf + len, ret);
+			}
+			return ret;
+		}
+		else {
+			StringStream ss;
+			ss << str;
+			_T ret;
+			ss >> ret;
+			return ret;
+		}
+	}
+
+	/*
+	Converts val to its stored form. Numbers are written with to_chars, and enums as numbers of their underlying type.
+	Other types are streamed to a StringStream.
+	*/
+	template<class _T>
+	static String toString(const _T& val) {
+		if constexpr (std::is_same<_T, bool>::value) {
+			return String(1, val ? Char('1') : Char('0'));
+		}
+		else if constexpr (std::is_enum<_T>::value) {
+			return toString((_EnumNumberT<_T>)val);
+		}
+		else if constexpr (isCharsConvertible<_T>) {
+			char buf[128];
+			auto res = std::to_chars(buf, buf + sizeof(buf), val);
+			return String(buf, res.ptr);
+		}
+		else {
+			StringStream ss;
+			ss << val;
+			return ss.str();
+		}
+	}
+
+	// Returns the section, inserting it if it doesn't exist
+	SectionMap& sectionFor(StringView sect) {
+		auto it = dataMap.find(sect);
+		if (it != dataMap.end())
+			return it->second;
+		touchSection();
+		return dataMap.try_emplace(String(sect)).first->second;
+	}
+
+	const String* findRaw(StringView sect, StringView key) const {
+		auto sit = dataMap.find(sect);
+		if (sit == dataMap.end())
+			return nullptr;
+		auto it = sit->second.find(key);
+		return (it != sit->second.end()) ? &it->second : nullptr;
+	}
+
+	static String environmentValue(StringView name) {
+		std::string narrowName(name.begin(), name.end());
+		const char* val = std::getenv(narrowName.c_str());
+		return val ? String(val, val + strlen(val)) : String();
+	}
+
+	// Returns the expanded value if interpolation is enabled, or the stored value if not
+	const String& valueOf(StringView sect, StringView key, const String& raw) const {
+		if (!mInterpolate || raw.find(Char('$')) == String::npos)
+			return raw;
+
+		Expansion* exp = mExpansionCache.find(&raw);
+		if (exp && exp->valid.load(std::memory_order_acquire))
+			return exp->value;
+
+		std::lock_guard<std::mutex> lock(mExpansionCache.mutex);
+		return expand(sect, key, raw);
+	}
+
+	/*
+	Expands the references in the stored value of the key, which must be the one stored in dataMap.
+	Needs the expansion cache to be locked.
+	*/
+	const String& expand(StringView sect, StringView key, const String& raw) const {
+		auto& sectExpansions = mExpansionCache.expansions;
+		auto sit = sectExpansions.find(sect);
+		if (sit == sectExpansions.end())
+			sit = sectExpansions.try_emplace(String(sect)).first;
+		auto it = sit->second.find(key);
+		if (it == sit->second.end())
+			it = sit->second.try_emplace(String(key)).first;
+
+		Expansion& exp = it->second;
+		mExpansionCache.addToIndex(&raw, &exp);
+		if (exp.valid.load(std::memory_order_relaxed))
+			return exp.value;
+		if (exp.expanding)
+			throw InterpolationError(((std::stringstream&)(std::stringstream() <<
+				"Interpolation cycle at key \"" << std::string(key.begin(), key.end()) <<
+				"\" in section \"" << std::string(sect.begin(), sect.end()) << "\"!")).str());
+
+		exp.expanding = true;
+		try {
+			String result;
+			StringView text(raw);
+			size_t pos = 0;
+			while (pos < text.size()) {
+				size_t dollar = text.find(Char('$'), pos);
+				result.append(text.substr(pos, dollar - pos));
+				if (dollar == StringView::npos || dollar + 1 == text.size()) {
+					if (dollar != StringView::npos)
+						result += Char('$');
+					break;
+				}
+
+				if (text[dollar + 1] == Char('$')) {
+					result += Char('$');
+					pos = dollar + 2;
+					continue;
+				}
+				size_t close = text.find(Char('}'), dollar + 2);
+				if (text[dollar + 1] != Char('{') || close == StringView::npos) {
+					result += Char('$');
+					pos = dollar + 1;
+					continue;
+				}
+
+				StringView ref = text.substr(dollar + 2, close - dollar - 2);
+				size_t colon = ref.find(Char(':'));
+				if (colon == StringView::npos) {
+					result += environmentValue(ref);
+				}
+				else {
+					StringView refSect = ref.substr(0, colon);
+					StringView refKey = ref.substr(colon + 1);
+
+					// Record the dependency with names stored in the cache, so they outlive the value
+					auto dsit = mExpansionCache.dependents.find(refSect);
+					if (dsit == mExpansionCache.dependents.end())
+						dsit = mExpansionCache.dependents.try_emplace(String(refSect)).first;
+					auto dit = dsit->second.find(refKey);
+					if (dit == dsit->second.end())
+						dit = dsit->second.try_emplace(String(refKey)).first;
+					std::pair<StringView, StringView> dependent(sit->first, it->first);
+					if (std::find(dit->second.begin(), dit->second.end(), dependent) == dit->second.end())
+						dit->second.push_back(dependent);
+
+					const String* refRaw = findRaw(refSect, refKey);
+					if (refRaw) {
+						if (refRaw->find(Char('$')) == String::npos)
+							result += *refRaw;
+						else
+							result += expand(refSect, refKey, *refRaw);
+					}
+				}
+				pos = close + 1;
+			}
+
+			exp.value = std::move(result);
+		}
+		catch (...) {
+			exp.expanding = false;
+			throw;
+		}
+		exp.expanding = false;
+		exp.valid.store(true, std::memory_order_release);
+		return exp.value;
+	}
+
+	template<class _F, class... _Args>
+	static auto invokeCallback(_F& f, _Args... args) {
+		if constexpr (std::is_void<decltype(f(args...))>::value) {
+			f(args...);
+			return ParseAction::Continue;
+		}
+		else {
+			return ParseAction(f(args...));
+		}
+	}
+
+	/*
+	Parses the lines of the text for parse(), passing them to the callbacks.
+	Unless final is set, the last line is only parsed if it's terminated, since the rest of it may not have been read yet.
+	consumed is set to the length of the parsed part. Returns false if a callback stopped the parsing.
+	*/
+	template<class _OnSectionT, class _OnKeyValueT>
+	static bool parseLines(StringView text, bool final, size_t& consumed, size_t& line, bool& skipSection, bool ignoreErrors,
+		bool validateUtf8, _OnSectionT& onSection, _OnKeyValueT& onKeyValue)
+	{
+		size_t pos = 0;
+
+		while (pos < text.size()) {
+			size_t end = text.find(Char('\n'), pos);
+			if (end == StringView::npos) {
+				if (!final)
+					break;
+				end = text.size();
+			}
+			line++;
+
+			StringView ln = text.substr(pos, end - pos);
+			StringView first, second;
+			ParseAction action = ParseAction::Continue;
+			LineKind kind = tokenizeLine(ln, first, second);
+			if (validateUtf8 && kind != LineKind::Empty && !isValidUtf8(ln)) {
+				if (!ignoreErrors)
+					throwFormatError(line, "Invalid UTF-8");
+				kind = LineKind::Empty;
+			}
+
+			switch (kind) {
+			case LineKind::Section:
+				skipSection = false;
+				action = invokeCallback(onSection, first);
+				break;
+			case LineKind::KeyValue:
+				if (!skipSection)
+					action = invokeCallback(onKeyValue, first, second);
+				break;
+			case LineKind::Invalid:
+				if (!ignoreErrors)
+					throwFormatError(line);
+				break;
+			case LineKind::Empty:
+				break;
+			}
+
+			pos = end + 1;
+			if (action == ParseAction::Stop) {
+				consumed = std::min(pos, text.size());
+				return false;
+			}
+			if (action == ParseAction::SkipSection) {
+				skipSection = true;
+			}
+		}
+
+		consumed = std::min(pos, text.size());
+		return true;
+	}
+
+	[[noreturn]] static void throwFormatError(size_t line, const char* reason = "Wrong ini file format") {
+		throw FormatException(((std::stringstream&)(std::stringstream() <<
+			reason << " at line " << line << "!"
+			)).str(), line);
+	}
+
+	// Decodes the UTF-8 sequence at pos and moves pos after it. Invalid sequences are decoded as U+FFFD, one byte at a time.
+	static char32_t decodeUtf8(StringView str, size_t& pos) {
+		size_t len = utf8SequenceLength(str, pos);
+		if (!len) {
+			pos++;
+			return 0xFFFD;
+		}
+
+		unsigned char b = (unsigned char)str[pos];
+		char32_t cp = (len == 1) ? b : (b & (0x7F >> len));
+		for (size_t i = 1; i < len; i++) {
+			cp = (cp << 6) | ((unsigned char)str[pos + i] & 0x3F);
+		}
+		pos += len;
+		return cp;
+	}
+
+	// Returns the length of the valid UTF-8 sequence at pos, or 0 if it's invalid
+	static size_t utf8SequenceLength(StringView str, size_t pos) {
+		unsigned char b0 = (unsigned char)str[pos];
+		if (b0 < 0x80)
+			return 1;
+
+		size_t len;
+		unsigned char lo = 0x80, hi = 0xBF;// The range of the second byte
+		if (b0 >= 0xC2 && b0 <= 0xDF) len = 2;
+		else if (b0 == 0xE0) len = 3, lo = 0xA0;// Overlong
+		else if (b0 == 0xED) len = 3, hi = 0x9F;// Surrogates
+		else if (b0 >= 0xE1 && b0 <= 0xEF) len = 3;
+		else if (b0 == 0xF0) len = 4, lo = 0x90;// Overlong
+		else if (b0 == 0xF4) len = 4, hi = 0x8F;// Above U+10FFFF
+		else if (b0 >= 0xF1 && b0 <= 0xF3) len = 4;
+		else return 0;
+
+		if (str.size() - pos < len)
+			return 0;
+		unsigned char b1 = (unsigned char)str[pos + 1];
+		if (b1 < lo || b1 > hi)
+			return 0;
+		for (size_t i = 2; i < len; i++) {
+			if (((unsigned char)str[pos + i] & 0xC0) != 0x80)
+				return 0;
+		}
+		return len;
+	}
+
+	static void appendUtf8(String& out, char32_t cp) {
+		if (cp < 0x80) {
+			out += Char(cp);
+		}
+		else if (cp < 0x800) {
+			out += Char(0xC0 | (cp >> 6));
+			out += Char(0x80 | (cp & 0x3F));
+		}
+		else if (cp < 0x10000) {
+			out += Char(0xE0 | (cp >> 12));
+			out += Char(0x80 | ((cp >> 6) & 0x3F));
+			out += Char(0x80 | (cp & 0x3F));
+		}
+		else {
+			out += Char(0xF0 | (cp >> 18));
+			out += Char(0x80 | ((cp >> 12) & 0x3F));
+			out += Char(0x80 | ((cp >> 6) & 0x3F));
+			out += Char(0x80 | (cp & 0x3F));
+		}
+	}
+
+	// Converts UTF-8 to UTF-16 or UTF-32, depending on the size of the target's characters
+	template<class _OutT>
+	static _OutT fromUtf8(StringView str) {
+		static_assert(sizeof(Char) == 1, "UTF-8 conversions need a string of bytes");
+		using _OutChar = typename _OutT::value_type;
+		_OutT out;
+		out.reserve(str.size());
+		for (size_t pos = 0; pos < str.size();) {
+			char32_t cp = decodeUtf8(str, pos);
+			if (sizeof(_OutChar) == 2 && cp >= 0x10000) {
+				out += _OutChar(0xD800 + ((cp - 0x10000) >> 10));
+				out += _OutChar(0xDC00 + ((cp - 0x10000) & 0x3FF));
+			}
+			else {
+				out += _OutChar(cp);
+			}
+		}
+		return out;
+	}
+
+	// Converts UTF-16 or UTF-32 to UTF-8. Unpaired surrogates are converted to U+FFFD.
+	template<class _InChar>
+	static String toUtf8(std::basic_string_view<_InChar> str) {
+		static_assert(sizeof(Char) == 1, "UTF-8 conversions need a string of bytes");
+		String out;
+		out.reserve(str.size());
+		for (size_t i = 0; i < str.size(); i++) {
+			char32_t cp = (char32_t)str[i];
+			if (sizeof(_InChar) == 2 && cp >= 0xD800 && cp <= 0xDFFF) {
+				if (cp <= 0xDBFF && i + 1 < str.size() && (char32_t)str[i + 1] >= 0xDC00 && (char32_t)str[i + 1] <= 0xDFFF) {
+					cp = 0x10000 + ((cp - 0xD800) << 10) + ((char32_t)str[i + 1] - 0xDC00);
+					i++;
+				}
+				else {
+					cp = 0xFFFD;
+				}
+			}
+			else if (cp > 0x10FFFF || (cp >= 0xD800 && cp <= 0xDFFF)) {
+				cp = 0xFFFD;
+			}
+			appendUtf8(out, cp);
+		}
+		return out;
+	}
+
+	// Stores the content passed to the callbacks by parseFn(onSection, onKeyValue) into data
+	template<class _ParseFnT>
+	static void loadInto(DataMap& data, _ParseFnT&& parseFn) {
+		SectionMap* keyvalmap = nullptr;
+
+		auto onSection = [&](StringView name) {
+			auto it = data.find(name);
+			keyvalmap = (it != data.end()) ? &it->second : &data[String(name)];
+		};
+		auto onKeyValue = [&](StringView key, StringView val) {
+			if (!keyvalmap) {
+				keyvalmap = &data[String()];
+			}
+			_StorageT::load(*keyvalmap, key, val);
+		};
+
+		try {
+			parseFn(onSection, onKeyValue);
+		}
+		catch (...) {
+			_StorageT::finishLoad(data);
+			throw;
+		}
+		_StorageT::finishLoad(data);
+	}
+
+	// Stores the content passed to the callbacks by parseFn(onSection, onKeyValue), for readMore()
+	template<class _ParseFnT>
+	void load(_ParseFnT&& parseFn) {
+		touch(true);
+		mAllDirty = true;
+		loadInto(dataMap, parseFn);
+	}
+
+	// The smallest part of the text that readMoreParallel() gives to a thread
+	static constexpr size_t parallelChunkMin = 1 << 20;
+
+	// Returns the start of the first line at or after pos that is a section header, or the text size if there is none
+	static size_t nextSectionStart(StringView text, size_t pos) {
+		if (pos && text[pos - 1] != Char('\n')) {
+			pos = text.find(Char('\n'), pos);
+			if (pos == StringView::npos)
+				return text.size();
+			pos++;
+		}
+
+		while (pos < text.size()) {
+			size_t c = pos;
+			while (c < text.size() && isSpace(text[c])) c++;
+			if (c < text.size() && text[c] == Char('['))
+				return pos;
+
+			pos = text.find(Char('\n'), c);
+			if (pos == StringView::npos)
+				return text.size();
+			pos++;
+		}
+		return text.size();
+	}
+
+public:
+
+	/*
+	The layout of the binary image written by saveBinary().
+	The header is followed by the sections sorted by name, the entries of each section sorted by key,
+	and the block of Chars that the names, keys and values point into.
+	The image uses the machine's byte order and is meant as a local cache, not for exchanging files.
+	*/
+	struct _BinaryHeader {
+		char magic[4];// "MINI"
+		uint32_t version;
+		uint32_t charSize;
+		uint32_t hasSource;// Whether the source fields describe the file the image was made from
+		uint64_t sourceSize;
+		int64_t sourceTime;// The file's modification time, in file clock ticks
+		uint64_t sourceHash;// The FNV-1a hash of the file
+		uint64_t sectionCount;
+		uint64_t entryCount;
+		uint64_t blobSize;// In Chars
+	};
+
+	struct _BinarySection {
+		uint64_t nameOffset;
+		uint32_t nameLength;
+		uint32_t entryCount;
+		uint64_t firstEntry;
+	};
+
+	struct _BinaryEntry {
+		uint64_t keyOffset;
+		uint64_t valueOffset;
+		uint32_t keyLength;
+		uint32_t valueLength;
+	};
+
+	static constexpr uint32_t binary_version = 1;
 
 private:
-	String mFilename;
-	bool mAutoSync;
+
+	// A section to write to a binary image, with views of its name, keys and values
+	struct _BinarySectionView {
+		StringView name;
+		std::vector<std::pair<StringView, StringView> > entries;
+	};
+
+	static uint64_t hashBytes(const char* data, size_t size) {
+		uint64_t hash = 14695981039346656037ull;
+		for (size_t i = 0; i < size; i++) {
+			hash = (hash ^ (unsigned char)data[i]) * 1099511628211ull;
+		}
+		return hash;
+	}
+
+	// Returns the header with the source fields describing the file, or without them if the file can't be read
+	static _BinaryHeader binaryStamp(const std::filesystem::path& source) {
+		_BinaryHeader header = {};
+		try {
+			header.sourceTime = (int64_t)std::filesystem::last_write_time(source).time_since_epoch().count();
+			MappedFile file(source.string());
+			header.sourceSize = file.size();
+			header.sourceHash = hashBytes(file.data(), file.size());
+			header.hasSource = 1;
+		}
+		catch (const std::exception&) {
+			header.hasSource = 0;
+		}
+		return header;
+	}
+
+	/*
+	Returns whether the image was made from the current content of the file.
+	If the size and modification time match the file isn't read.
+	If only the time differs, e.g. when the file was touched or copied, its hash is checked.
+	*/
+	static bool isBinaryCurrent(const _BinaryHeader& header, const std::filesystem::path& source) {
+		std::error_code err;
+		uint64_t size = std::filesystem::file_size(source, err);
+		if (err || !header.hasSource || header.sourceSize != size)
+			return false;
+		auto time = std::filesystem::last_write_time(source, err);
+		if (err)
+			return false;
+		if (header.sourceTime == (int64_t)time.time_since_epoch().count())
+			return true;
+
+		_BinaryHeader current = binaryStamp(source);
+		return current.hasSource && current.sourceSize == header.sourceSize && current.sourceHash == header.sourceHash;
+	}
+
+	// Checks that the data starts with a valid image and returns its header. Throws FormatException if it doesn't.
+	static const _BinaryHeader& checkBinary(const char* data, size_t size) {
+		const _BinaryHeader* header = (const _BinaryHeader*)data;
+		if (size < sizeof(_BinaryHeader) ||
+			memcmp(header->magic, "MINI", 4) != 0 ||
+			header->version != binary_version ||
+			header->charSize != sizeof(Char))
+			throw FormatException("Invalid binary ini image!", 0);
+
+		size_t left = size - sizeof(_BinaryHeader);
+		if (header->sectionCount > left / sizeof(_BinarySection) ||
+			(left -= header->sectionCount * sizeof(_BinarySection), header->entryCount > left / sizeof(_BinaryEntry)) ||
+			(left -= header->entryCount * sizeof(_BinaryEntry), header->blobSize > left / sizeof(Char)))
+			throw FormatException("Truncated binary ini image!", 0);
+		return *header;
+	}
+
+	/*
+	Checks that every record of the image checked by checkBinary() points inside it, so it can be queried in place.
+	Throws FormatException if it doesn't.
+	*/
+	static void checkBinaryRecords(const char* data, const _BinaryHeader& header) {
+		const _BinarySection* sections = (const _BinarySection*)(data + sizeof(_BinaryHeader));
+		const _BinaryEntry* entries = (const _BinaryEntry*)(sections + header.sectionCount);
+		auto inBlob = [&](uint64_t offset, uint32_t length) {
+			return offset <= header.blobSize && length <= header.blobSize - offset;
+		};
+
+		for (uint64_t i = 0; i < header.sectionCount; i++) {
+			const _BinarySection& sect = sections[i];
+			if (!inBlob(sect.nameOffset, sect.nameLength) ||
+				sect.firstEntry > header.entryCount || sect.entryCount > header.entryCount - sect.firstEntry)
+				throw FormatException("Corrupted binary ini image!", 0);
+		}
+		for (uint64_t i = 0; i < header.entryCount; i++) {
+			if (!inBlob(entries[i].keyOffset, entries[i].keyLength) || !inBlob(entries[i].valueOffset, entries[i].valueLength))
+				throw FormatException("Corrupted binary ini image!", 0);
+		}
+	}
+
+	// Writes the image of the sections, filling in the header fields other than the source ones
+	static void writeBinary(std::ostream& os, _BinaryHeader header, std::vector<_BinarySectionView>& sections) {
+		std::sort(sections.begin(), sections.end(),
+			[](const _BinarySectionView& a, const _BinarySectionView& b) { return a.name < b.name; });
+
+		// Each distinct key is stored once, since the same keys tend to repeat in many sections, unlike the values
+		std::vector<Char> blob;
+		std::unordered_map<StringView, uint64_t> offsets;
+		auto storeKey = [&](StringView str) {
+			auto inserted = offsets.try_emplace(str, blob.size());
+			if (inserted.second)
+				blob.insert(blob.end(), str.begin(), str.end());
+			return inserted.first->second;
+		};
+		auto store = [&](StringView str) {
+			uint64_t offset = blob.size();
+			blob.insert(blob.end(), str.begin(), str.end());
+			return offset;
+		};
+
+		std::vector<_BinarySection> sectionRecords;
+		std::vector<_BinaryEntry> entryRecords;
+		sectionRecords.reserve(sections.size());
+		for (auto& sect : sections) {
+			std::sort(sect.entries.begin(), sect.entries.end());
+			sectionRecords.push_back({ store(sect.name), (uint32_t)sect.name.size(), (uint32_t)sect.entries.size(), entryRecords.size() });
+			for (auto& entry : sect.entries) {
+				uint64_t keyOffset = storeKey(entry.first);
+				uint64_t valueOffset = store(entry.second);
+				entryRecords.push_back({ keyOffset, valueOffset, (uint32_t)entry.first.size(), (uint32_t)entry.second.size() });
+			}
+		}
+
+		memcpy(header.magic, "MINI", 4);
+		header.version = binary_version;
+		header.charSize = sizeof(Char);
+		header.sectionCount = sectionRecords.size();
+		header.entryCount = entryRecords.size();
+		header.blobSize = blob.size();
+
+		os.write((const char*)&header, sizeof(header));
+		os.write((const char*)sectionRecords.data(), sectionRecords.size() * sizeof(_BinarySection));
+		os.write((const char*)entryRecords.data(), entryRecords.size() * sizeof(_BinaryEntry));
+		os.write((const char*)blob.data(), blob.size() * sizeof(Char));
+	}
+
+	// Writes the image to the file through a temporary file, like sync(). Returns false if it can't be written.
+	static bool writeBinaryFile(const std::filesystem::path& path, const _BinaryHeader& header, std::vector<_BinarySectionView>& sections) {
+		std::filesystem::path tmpPath(path);
+		tmpPath += ".tmp";
+		std::error_code err;
+		{
+			std::ofstream file(tmpPath, std::ios::out | std::ios::binary | std::ios::trunc);
+			if (file.good())
+				writeBinary(file, header, sections);
+			if (!file.good()) {
+				file.close();
+				std::filesystem::remove(tmpPath, err);
+				return false;
+			}
+		}
+		std::filesystem::rename(tmpPath, path, err);
+		if (err) {
+			std::filesystem::remove(tmpPath, err);
+			return false;
+		}
+		return true;
+	}
+
+	std::vector<_BinarySectionView> binarySections() const {
+		std::vector<_BinarySectionView> sections;
+		sections.reserve(dataMap.size());
+		for (auto& sect : dataMap) {
+			sections.push_back({ StringView(sect.first), {} });
+			sections.back().entries.reserve(sect.second.size());
+			for (auto& keyval : sect.second) {
+				sections.back().entries.emplace_back(StringView(keyval.first), StringView(keyval.second));
+			}
+		}
+		return sections;
+	}
+
+	// Adds the content of the image to dataMap. Throws FormatException if the image is invalid.
+	void readBinary(const char* data, size_t size) {
+		const _BinaryHeader& header = checkBinary(data, size);
+		const _BinarySection* sections = (const _BinarySection*)(data + sizeof(_BinaryHeader));
+		const _BinaryEntry* entries = (const _BinaryEntry*)(sections + header.sectionCount);
+		StringView blob((const Char*)(entries + header.entryCount), header.blobSize);
+
+		auto str = [&](uint64_t offset, uint32_t length) {
+			if (offset > blob.size() || length > blob.size() - offset)
+				throw FormatException("Corrupted binary ini image!", 0);
+			return blob.substr(offset, length);
+		};
+
+		touch(true);
+		mAllDirty = true;
+		loadInto(dataMap, [&](auto& onSection, auto& onKeyValue) {
+			for (uint64_t i = 0; i < header.sectionCount; i++) {
+				const _BinarySection& sect = sections[i];
+				if (sect.firstEntry > header.entryCount || sect.entryCount > header.entryCount - sect.firstEntry)
+					throw FormatException("Corrupted binary ini image!", 0);
+
+				onSection(str(sect.nameOffset, sect.nameLength));
+				for (uint64_t j = sect.firstEntry; j < sect.firstEntry + sect.entryCount; j++) {
+					onKeyValue(str(entries[j].keyOffset, entries[j].keyLength), str(entries[j].valueOffset, entries[j].valueLength));
+				}
+			}
+		});
+	}
 
 public:
 
@@ -56,19 +1729,160 @@ public:
 		size_t line;
 	};
 
-	std::map<String, std::map<String, String> > dataMap;// dataMap[section][key] = value
+	struct InterpolationError : public std::runtime_error {
+		InterpolationError(const std::string& what) : std::runtime_error(what) {}
+	};
+
+	/*
+	A handle to a (section, key) pair, created by bind().
+	The pair is looked up once, after which reading it only checks whether the MiIni has changed.
+	The handle finds the value again by itself when keys were added or removed (see generation()), e.g. by read() or close(),
+	and setStr() updates don't invalidate it.
+	The value is cached converted to _T and only reconverted after the MiIni was modified (see revision()),
+	so reading an unchanged value is a plain load.
+	A handle must not outlive its MiIni, and must not be used by several threads at once.
+	*/
+	template<class _T = String>
+	class Key {
+	private:
+		friend MiIni;
+
+		const MiIni* mOwner;
+		String mSect;
+		String mKey;
+		_T mDef;
+		mutable const String* mValue;
+		mutable size_t mGeneration;
+		mutable size_t mRevision;
+		mutable _T mCached;
+
+		Key(const MiIni* owner, StringView sect, StringView key, _T def) :
+			mOwner(owner),
+			mSect(sect),
+			mKey(key),
+			mDef(std::move(def)),
+			mValue(nullptr),
+			mGeneration(owner->mGeneration - 1),
+			mRevision(owner->mRevision - 1)
+		{
+			refresh();
+		}
+
+		void refresh() const {
+			// Expanded values can be replaced by any modification
+			if (mGeneration != mOwner->mGeneration || mOwner->mInterpolate) {
+				mValue = mOwner->find(mSect, mKey);
+				mGeneration = mOwner->mGeneration;
+			}
+			if (!mValue) {
+				mCached = mDef;
+			}
+			else if constexpr (std::is_same<_T, String>::value) {
+				mCached = *mValue;
+			}
+			else {
+				mCached = fromString<_T>(*mValue);
+			}
+			mRevision = mOwner->mRevision;
+		}
+
+	public:
+		// An unbound handle, which must be assigned one returned by MiIni::bind() before it's used
+		Key() : mOwner(nullptr), mValue(nullptr), mGeneration(0), mRevision(0) {}
+
+		// Returns the value converted to _T, or the default value if it doesn't exist. Must not be called on an unbound handle.
+		const _T& get() const {
+			if (mRevision != mOwner->mRevision || mGeneration != mOwner->mGeneration)
+				refresh();
+			return mCached;
+		}
+
+		// Returns whether the value exists
+		bool exists() const {
+			get();
+			return mValue != nullptr;
+		}
+
+		StringView section() const {
+			return mSect;
+		}
+
+		StringView key() const {
+			return mKey;
+		}
+	};
+
+	DataMap dataMap;// dataMap[section][key] = value
 
-	MiIni(): mAutoSync(false) {}
+	MiIni(): mAutoSync(false), mGeneration(0), mRevision(0), mDirtyTracking(false), mAllDirty(false), mInterpolate(false), mValidateUtf8(false) {}
 
 	/*
 	@param filename The name of the file to open and read
 	@param autosync If enabled, the file will automatically be synced to this MinIni's content before being closed
 	*/
-	MiIni(String filename, bool autosync) {
+	MiIni(String filename, bool autosync): mAutoSync(false), mGeneration(0), mRevision(0), mDirtyTracking(false), mAllDirty(false), mInterpolate(false), mValidateUtf8(false) {
 		open(filename, autosync);
 	}
-	
-	// Default copy-constructors and assignments are okay
+
+	// A copy starts with the other's counters, since no Key is bound to it yet
+	MiIni(const MiIni& other) = default;
+
+	// The moved-from MiIni is left empty and unlinked, so it doesn't sync over the linked file when closed
+	MiIni(MiIni&& other):
+		mFilename(std::move(other.mFilename)),
+		mAutoSync(other.mAutoSync),
+		mGeneration(other.mGeneration),
+		mRevision(other.mRevision),
+		mDirtyTracking(other.mDirtyTracking),
+		mAllDirty(other.mAllDirty),
+		mDirtyKeys(std::move(other.mDirtyKeys)),
+		mInterpolate(other.mInterpolate),
+		mValidateUtf8(other.mValidateUtf8),
+		dataMap(std::move(other.dataMap))
+	{
+		other.releaseContent();
+	}
+
+	/*
+	Assignments replace the content that the Keys bound to this MiIni point into,
+	so they move the counters past any value those Keys have seen.
+	*/
+	MiIni& operator=(const MiIni& other) {
+		size_t generation = std::max(mGeneration, other.mGeneration) + 1;
+		size_t revision = std::max(mRevision, other.mRevision) + 1;
+		mFilename = other.mFilename;
+		mAutoSync = other.mAutoSync;
+		mDirtyTracking = other.mDirtyTracking;
+		mAllDirty = other.mAllDirty;
+		mDirtyKeys = other.mDirtyKeys;
+		mInterpolate = other.mInterpolate;
+		mValidateUtf8 = other.mValidateUtf8;
+		mExpansionCache = other.mExpansionCache;
+		dataMap = other.dataMap;
+		mGeneration = generation;
+		mRevision = revision;
+		return *this;
+	}
+
+	MiIni& operator=(MiIni&& other) {
+		if (this == &other)
+			return *this;
+		size_t generation = std::max(mGeneration, other.mGeneration) + 1;
+		size_t revision = std::max(mRevision, other.mRevision) + 1;
+		mFilename = std::move(other.mFilename);
+		mAutoSync = other.mAutoSync;
+		mDirtyTracking = other.mDirtyTracking;
+		mAllDirty = other.mAllDirty;
+		mDirtyKeys = std::move(other.mDirtyKeys);
+		mInterpolate = other.mInterpolate;
+		mValidateUtf8 = other.mValidateUtf8;
+		mExpansionCache.clear();
+		dataMap = std::move(other.dataMap);
+		mGeneration = generation;
+		mRevision = revision;
+		other.releaseContent();
+		return *this;
+	}
 
 	~MiIni() {
 		close();
@@ -97,71 +1911,304 @@ public:
 	}
 
 	// Returns the String value if it exists. If not, inserts the default value (def) and returns it
-	String getStr(String sect, String key, String def = String()) {
-		auto& keyvalmap = dataMap[sect];
+	String getStr(StringView sect, StringView key, StringView def = StringView()) {
+		auto& keyvalmap = sectionFor(sect);
 
 		auto it = keyvalmap.find(key);
 		if (it == keyvalmap.end()) {
-			keyvalmap.insert(std::make_pair(key, def));
-			return def;
+			keyvalmap.try_emplace(String(key), def);
+			touch(true, sect, key);
+			return String(def);
 		}
 		else {
-			return it->second;
+			return valueOf(sect, key, it->second);
 		}
 	}
 
 	// Sets the value to the String
-	void setStr(String sect, String key, String val) {
-		dataMap[sect][key] = val;
+	void setStr(StringView sect, StringView key, StringView val) {
+		auto& keyvalmap = sectionFor(sect);
+
+		auto it = keyvalmap.find(key);
+		if (it == keyvalmap.end()) {
+			keyvalmap.try_emplace(String(key), val);
+			touch(true, sect, key);
+		}
+		else if (it->second != val) {
+			it->second.assign(val.data(), val.size());
+			touch(false, sect, key);
+		}
 	}
 
-	// Returns the value if it exists. If not, inserts the default value (def) and returns it. val must be streamable to and from a StringStream.
+	/*
+	Returns the value if it exists. If not, inserts the default value (def) and returns it.
+	Numbers and booleans are converted without allocating, other types must be streamable to and from a StringStream.
+	*/
 	template<class _T>
-	_T get(String sect, String key, _T def = _T()) {
-		StringStream ss;
-		auto& keyvalmap = dataMap[sect];
+	_T get(StringView sect, StringView key, _T def = _T()) {
+		auto& keyvalmap = sectionFor(sect);
 
 		auto it = keyvalmap.find(key);
 		if (it == keyvalmap.end()) {
-			ss << def;
-			keyvalmap.insert(std::make_pair(key, ss.str()));
+			keyvalmap.try_emplace(String(key), toString(def));
+			touch(true, sect, key);
 			return def;
 		}
 		else {
-			ss << it->second;
-			_T ret;
-			ss >> ret;
-			return ret;
+			return fromString<_T>(valueOf(sect, key, it->second));
 		}
 	}
 
-	std::string get(String sect, String key, const char* def = "") {
-		return get(sect, key, std::string(def));
+	String get(StringView sect, StringView key, const Char* def) {
+		return get(sect, key, String(def));
+	}
+
+	// Sets the value to val. Numbers and booleans are converted without a StringStream, other types must be streamable to it.
+	template<class _T>
+	void set(StringView sect, StringView key, const _T& val) {
+		setStr(sect, key, toString(val));
+	}
+
+	// Returns the section's key-value map if it exists, or nullptr if it doesn't. Never modifies the MiIni.
+	const SectionMap* findSection(StringView sect) const {
+		auto it = dataMap.find(sect);
+		return (it != dataMap.end()) ? &it->second : nullptr;
+	}
+
+	/*
+	Returns a pointer to the value if it exists, or nullptr if it doesn't.
+	Never modifies the MiIni, so it's safe to call concurrently with other const methods.
+	The pointer is valid until the MiIni is modified. With interpolation enabled, it points to the expanded value.
+	*/
+	const String* find(StringView sect, StringView key) const {
+		const String* raw = findRaw(sect, key);
+		return raw ? &valueOf(sect, key, *raw) : nullptr;
 	}
 
-	std::string get(String sect, String key, const wchar_t* def = "") {
-		return get(sect, key, std::wstring(def));
+	// Returns the value converted to _T like in get(), or an empty optional if it doesn't exist. Never modifies the MiIni.
+	template<class _T>
+	std::optional<_T> tryGet(StringView sect, StringView key) const {
+		const String* val = find(sect, key);
+		if (!val)
+			return std::nullopt;
+		return fromString<_T>(*val);
 	}
 
-	// Sets the value to val. val must be streamable to a StringStream.
+	// Returns the value converted to _T like in get(), or def if it doesn't exist. Unlike get(), it never inserts def.
 	template<class _T>
-	void set(String sect, String key, _T val) {
-		StringStream ss;
-		ss << val;
-		setStr(sect, key, ss.str());
+	_T getOr(StringView sect, StringView key, _T def) const {
+		const String* val = find(sect, key);
+		if (!val)
+			return def;
+		return fromString<_T>(*val);
+	}
+
+	String getOr(StringView sect, StringView key, const Char* def) const {
+		return getOr(sect, key, String(def));
+	}
+
+	/*
+	Looks up the (sect, key) pair once and returns a handle for fast repeated reads. See Key.
+	def is returned by the handle while the value doesn't exist. Never modifies the MiIni.
+	*/
+	template<class _T = String>
+	Key<_T> bind(StringView sect, StringView key, _T def = _T()) const {
+		return Key<_T>(this, sect, key, std::move(def));
+	}
+
+	/*
+	Changes whenever keys or sections are added or removed, which can move the stored values.
+	Pointers returned by find() and findSection() stay valid while it doesn't change.
+	*/
+	size_t generation() const {
+		return mGeneration;
+	}
+
+	// Changes whenever the content is modified through the MiIni's methods
+	size_t revision() const {
+		return mRevision;
+	}
+
+	// Call after modifying dataMap directly, so handles from bind() and MiIniLayered caches notice the change
+	void invalidateHandles() {
+		touch(true);
+	}
+
+	/*
+	If enabled, reading checks that the text is valid UTF-8, and treats the lines that aren't as improperly formatted.
+	Together with the conversions of getWStr(), getU16Str(), setWStr() and setU16Str() this makes MiIni<std::string>
+	a UTF-8 ini, that parses and stores the bytes as they are, and only converts the values that are asked for as wide strings.
+	Only for strings of bytes.
+	*/
+	void enableUtf8Validation(bool enable = true) {
+		static_assert(sizeof(Char) == 1, "UTF-8 validation needs a string of bytes");
+		mValidateUtf8 = enable;
+	}
+
+	bool utf8ValidationEnabled() const {
+		return mValidateUtf8;
+	}
+
+	// Returns the UTF-8 value converted to a wide string if it exists, or def if it doesn't. Never modifies the MiIni.
+	std::wstring getWStr(StringView sect, StringView key, std::wstring_view def = std::wstring_view()) const {
+		const String* val = find(sect, key);
+		return val ? fromUtf8<std::wstring>(*val) : std::wstring(def);
+	}
+
+	// Returns the UTF-8 value converted to UTF-16 if it exists, or def if it doesn't. Never modifies the MiIni.
+	std::u16string getU16Str(StringView sect, StringView key, std::u16string_view def = std::u16string_view()) const {
+		const String* val = find(sect, key);
+		return val ? fromUtf8<std::u16string>(*val) : std::u16string(def);
+	}
+
+	// Sets the value to the wide string, converted to UTF-8
+	void setWStr(StringView sect, StringView key, std::wstring_view val) {
+		setStr(sect, key, toUtf8(val));
+	}
+
+	// Sets the value to the UTF-16 string, converted to UTF-8
+	void setU16Str(StringView sect, StringView key, std::u16string_view val) {
+		setStr(sect, key, toUtf8(val));
+	}
+
+	/*
+	If enabled, the values returned by getStr(), get(), find() and the other getters have their references expanded:
+	${section:key} is replaced by the value of the key in the section (expanded as well), ${NAME} by the environment variable NAME,
+	and $$ by $. References to missing keys and variables expand to nothing.
+	Each value is expanded on its first access and cached, and setStr() only invalidates the values that reference the changed key,
+	so reading an expanded value again costs the same as reading a plain one.
+	Environment variables are read once, when the value referencing them is expanded.
+	The values are stored and written unexpanded. A reference cycle throws InterpolationError from the getter.
+	*/
+	void enableInterpolation(bool enable = true) {
+		mInterpolate = enable;
+		mExpansionCache.clear();
+	}
+
+	bool interpolationEnabled() const {
+		return mInterpolate;
+	}
+
+	/*
+	If enabled, the modified keys are recorded (see dirtyKeys()),
+	and sync() skips writing the file entirely while nothing was modified since the last open() or sync().
+	*/
+	void enableDirtyTracking(bool enable = true) {
+		mDirtyTracking = enable;
+	}
+
+	bool dirtyTrackingEnabled() const {
+		return mDirtyTracking;
+	}
+
+	// Whether the content was modified since it was read from or synced to the linked file
+	bool isDirty() const {
+		return mAllDirty || !mDirtyKeys.empty();
+	}
+
+	// The (section, key) pairs modified through the MiIni's methods since the last open() or sync(), if dirty tracking is enabled
+	const std::set<std::pair<String, String>, std::less<> >& dirtyKeys() const {
+		return mDirtyKeys;
+	}
+
+	// Call after modifying dataMap directly, so the next sync() writes the file
+	void markDirty() {
+		mAllDirty = true;
 	}
 
 	// Returns whether a section exists
-	bool exists(String sect) const {
+	bool exists(StringView sect) const {
 		return (dataMap.find(sect) != dataMap.end());
 	}
 
 	// Returns whether a value exists with the key in the section sect
-	bool exists(String sect, String key) const {
+	bool exists(StringView sect, StringView key) const {
 		auto it = dataMap.find(sect);
 		return (it != dataMap.end() && it->second.find(key) != it->second.end());
 	}
 
+	/*
+	Streaming (event based) ini parser, for inputs that don't need to be stored or are too big to be.
+	onSection(StringView name) is called for every section header, and onKeyValue(StringView key, StringView value) for every value.
+	The views point into the parser's buffer and are only valid during the call.
+	Values before the first section header belong to the section "", for which onSection() isn't called.
+	The callbacks can return void, or a ParseAction to skip the rest of the current section or stop parsing.
+	The stream is read through a buffer of bufferSize characters, so the memory use doesn't depend on the input size.
+	Only a line longer than the buffer makes it grow to fit the line.
+	Returns false if a callback stopped the parsing, and true otherwise.
+	Improper lines are handled the same way as in readMore(). With validateUtf8, lines that aren't valid UTF-8 are improper too.
+	*/
+	template<class _OnSectionT, class _OnKeyValueT>
+	static bool parse(InputStream& is, _OnSectionT&& onSection, _OnKeyValueT&& onKeyValue,
+		bool ignoreErrors = false, size_t bufferSize = 1 << 16, bool validateUtf8 = false)
+	{
+		String buffer(bufferSize ? bufferSize : 1, Char());
+		size_t filled = 0;
+		size_t line = 0;
+		bool skipSection = false;
+
+		for (;;) {
+			if (filled == buffer.size()) {
+				buffer.resize(buffer.size() * 2);
+			}
+			is.read(&buffer[filled], buffer.size() - filled);
+			size_t read = (size_t)is.gcount();
+			bool final = (filled + read < buffer.size());
+			filled += read;
+
+			size_t consumed;
+			if (!parseLines(StringView(buffer.data(), filled), final, consumed, line, skipSection, ignoreErrors, validateUtf8,
+				onSection, onKeyValue))
+				return false;
+			if (final)
+				return true;
+
+			std::copy(buffer.begin() + consumed, buffer.begin() + filled, buffer.begin());
+			filled -= consumed;
+		}
+	}
+
+	// Parses the ini formatted text the same way as parse() does for a stream, without copying it
+	template<class _OnSectionT, class _OnKeyValueT>
+	static bool parse(StringView text, _OnSectionT&& onSection, _OnKeyValueT&& onKeyValue, bool ignoreErrors = false,
+		bool validateUtf8 = false)
+	{
+		size_t consumed;
+		size_t line = 0;
+		bool skipSection = false;
+		return parseLines(text, true, consumed, line, skipSection, ignoreErrors, validateUtf8, onSection, onKeyValue);
+	}
+
+	/*
+	Returns whether the string is valid UTF-8, i.e. has no overlong sequences, surrogates or code points above U+10FFFF.
+	ASCII text, the common case, is checked 8 bytes at a time. Only for strings of bytes; other strings are always valid.
+	*/
+	static bool isValidUtf8(StringView str) {
+		if constexpr (sizeof(Char) != 1) {
+			return true;
+		}
+		else {
+			size_t pos = 0;
+			while (pos < str.size()) {
+				while (str.size() - pos >= 8) {
+					uint64_t word;
+					memcpy(&word, str.data() + pos, 8);
+					if (word & 0x8080808080808080ull)
+						break;
+					pos += 8;
+				}
+				if (pos == str.size())
+					break;
+
+				size_t len = utf8SequenceLength(str, pos);
+				if (!len)
+					return false;
+				pos += len;
+			}
+			return true;
+		}
+	}
+
 	/*
 	Reads the content from the stream, adding it to the already existing content.
 	The stream needs to be formatted as an ini file.If not, a FormatException will be thrown, unless ignoreErrors argument is enabled.
@@ -169,47 +2216,97 @@ public:
 	Note that specifying a FileStream as the input stream won't link the file, i.e. the filename won't be changed.
 	*/
 	void readMore(InputStream& is, bool ignoreErrors = false) {
-		String sect;
-		String ln;
-		size_t line = 0;
-		while (std::getline(is, ln)) {
-			line++;
-			size_t commentPos;
+		load([&](auto& onSection, auto& onKeyValue) {
+			parse(is, onSection, onKeyValue, ignoreErrors, 1 << 16, mValidateUtf8);
+		});
+	}
+
+	/*
+	Reads the ini formatted text, adding it to the already existing content.
+	The text is parsed in a single pass, and only the stored keys and values are copied.
+	Errors are handled the same way as when reading from a stream.
+	*/
+	void readMore(StringView text, bool ignoreErrors = false) {
+		load([&](auto& onSection, auto& onKeyValue) {
+			parse(text, onSection, onKeyValue, ignoreErrors, mValidateUtf8);
+		});
+	}
+
+	/*
+	Reads the ini formatted text like readMore(), but parses it on multiple threads.
+	The text is split at section headers into one part per thread, which are parsed into separate maps
+	and then merged in their order in the text. The result is the same as with readMore(),
+	including which value wins for duplicate keys, and what is loaded and reported when the format is wrong.
+	@param threads The number of threads to use, or 0 for one per hardware thread
+	Texts too small to benefit are parsed on the calling thread.
+	*/
+	void readMoreParallel(StringView text, bool ignoreErrors = false, unsigned threads = 0) {
+		if (!threads) {
+			threads = std::max(1u, std::thread::hardware_concurrency());
+		}
+		size_t chunkCount = std::min<size_t>(threads, text.size() / parallelChunkMin);
+		if (chunkCount <= 1) {
+			readMore(text, ignoreErrors);
+			return;
+		}
 
-			StringStream spacesSS;
-			spacesSS << " \t\r\n";
-			String spaces = spacesSS.str();
+		std::vector<size_t> bounds{ 0 };
+		for (size_t i = 1; i < chunkCount; i++) {
+			size_t b = nextSectionStart(text, std::max(bounds.back(), text.size() / chunkCount * i));
+			if (b > bounds.back() && b < text.size())
+				bounds.push_back(b);
+		}
+		bounds.push_back(text.size());
+		chunkCount = bounds.size() - 1;
 
-			ln.erase(0, ln.find_first_not_of(spaces));
-			ln.erase(ln.find_last_not_of(spaces) + 1);
-			if ((commentPos = ln.find_first_of('#')) != String::npos) {
-				ln.erase(commentPos);
+		std::vector<DataMap> chunks(chunkCount);
+		std::vector<std::exception_ptr> errors(chunkCount);
+		auto parseChunk = [&](size_t i) {
+			try {
+				loadInto(chunks[i], [&](auto& onSection, auto& onKeyValue) {
+					parse(text.substr(bounds[i], bounds[i + 1] - bounds[i]), onSection, onKeyValue, ignoreErrors, mValidateUtf8);
+				});
 			}
+			catch (...) {
+				errors[i] = std::current_exception();
+			}
+		};
 
-			if (ln.length()) {
-				if (ln[0] == '[') {
-					sect = ln.substr(1, ln.find_first_of(']') - 1);
-					sect.erase(0, sect.find_first_not_of(spaces));
-					sect.erase(sect.find_last_not_of(spaces) + 1);
-					dataMap[sect];
-				}
-				else {
-					size_t eqpos = ln.find_first_of('=');
-					if (eqpos == String::npos) {
-						if (!ignoreErrors)
-							throw FormatException(((std::stringstream&)(std::stringstream() <<
-								"Wrong ini file format at line " << line << "!"
-								)).str(), line);
-						continue;
-					}
+		std::vector<std::thread> workers;
+		workers.reserve(chunkCount - 1);
+		try {
+			for (size_t i = 1; i < chunkCount; i++)
+				workers.emplace_back(parseChunk, i);
+		}
+		catch (...) {
+			for (auto& w : workers) w.join();
+			throw;
+		}
+		parseChunk(0);
+		for (auto& w : workers) w.join();
 
-					String key = ln.substr(0, eqpos);
-					key.erase(key.find_last_not_of(spaces) + 1);
-					String val = ln.substr(eqpos + 1, String::npos);
-					val.erase(0, val.find_first_not_of(spaces));
+		// The parts after a failed one are never reached by readMore()
+		size_t used = 1;
+		while (used < chunkCount && !errors[used - 1]) used++;
 
-					dataMap[sect][key] = val;
-				}
+		// Merging from the last part back keeps the values that come last in the text
+		touch(true);
+		mAllDirty = true;
+		DataMap merged = std::move(chunks[used - 1]);
+		for (size_t i = used - 1; i-- > 0;) {
+			_StorageT::merge(merged, chunks[i]);
+		}
+		_StorageT::merge(merged, dataMap);
+		dataMap = std::move(merged);
+
+		if (errors[used - 1]) {
+			try {
+				std::rethrow_exception(errors[used - 1]);
+			}
+			catch (const FormatException& e) {
+				std::string what = e.what();
+				throwFormatError(e.line + std::count(text.begin(), text.begin() + bounds[used - 1], Char('\n')),
+					what.substr(0, what.rfind(" at line ")).c_str());
 			}
 		}
 	}
@@ -217,19 +2314,60 @@ public:
 	// Clears the content and reads it from the stream using readMore().
 	void read(InputStream& is, bool ignoreErrors = false) {
 		dataMap.clear();
+		touch(true);
 		readMore(is, ignoreErrors);
 	}
 
+	// Clears the content and reads it from the ini formatted text using readMore().
+	void read(StringView text, bool ignoreErrors = false) {
+		dataMap.clear();
+		touch(true);
+		readMore(text, ignoreErrors);
+	}
+
+	/*
+	Writes the content as a binary image, which loadBinary() reads without parsing.
+	The image stores each distinct key once, and contains the sections and keys sorted so MiIniView can look them up in place.
+	*/
+	void saveBinary(std::ostream& os) const {
+		std::vector<_BinarySectionView> sections = binarySections();
+		writeBinary(os, _BinaryHeader(), sections);
+	}
+
+	// Clears the content and reads it from a binary image written by saveBinary(). Throws FormatException if it isn't valid.
+	void loadBinary(std::istream& is) {
+		std::vector<uint64_t> buffer;// Keeps the records aligned
+		std::string chunk(1 << 16, '\0');
+		size_t size = 0;
+		while (is.read(&chunk[0], chunk.size()), is.gcount() > 0) {
+			buffer.resize((size + is.gcount() + sizeof(uint64_t) - 1) / sizeof(uint64_t));
+			memcpy((char*)buffer.data() + size, chunk.data(), (size_t)is.gcount());
+			size += (size_t)is.gcount();
+		}
+
+		dataMap.clear();
+		touch(true);
+		readBinary((const char*)buffer.data(), size);
+	}
+
 	// Writes the content to the output stream, formatted as an ini file
 	void write(OutputStream& os) const {
+		// Keys without a section have to come before any section header, whatever the storage order is
+		auto global = dataMap.find(StringView());
+		if (global != dataMap.end()) {
+			for (auto& keyval : global->second) {
+				os << keyval.first << " = " << keyval.second << '\n';
+			}
+			os << '\n';
+		}
 		for (auto& sect : dataMap) {
 			if (sect.first != String()) {
 				os << "[" << sect.first << "]\n";
+				for (auto& keyval : sect.second) {
+					os << keyval.first << " = " << keyval.second << '\n';
+				}
+				os << '\n';
 			}
-			for (auto& keyval : sect.second) {
-				os << keyval.first << " = " << keyval.second << std::endl;
-			}
-			os << std::endl;
 		}
 	}
 
@@ -243,29 +2381,114 @@ public:
 		mAutoSync = autosync;
 
 		FileStream file;
-		file.open(filename, std::ios::in);
+		file.open(std::filesystem::path(filename), std::ios::in);
 
 		if (file.good()) {
 			read(file, ignoreErrors);
 			file.close();
+			markClean();
+		}
+	}
+
+	/*
+	Reads the file and links it to this MinIni like open(), but memory-maps it and parses it with readMoreParallel().
+	Only for strings of chars.
+	*/
+	void openParallel(String filename, bool autosync, bool ignoreErrors = false, unsigned threads = 0) {
+		static_assert(sizeof(Char) == 1, "openParallel() needs a string of chars");
+		mFilename = filename;
+		mAutoSync = autosync;
+
+		MappedFile file;
+		try {
+			file.open(std::string(filename.begin(), filename.end()));
+		}
+		catch (const MappedFile::FileError&) {
+			return;
+		}
+
+		dataMap.clear();
+		touch(true);
+		readMoreParallel(StringView((const Char*)file.data(), file.size()), ignoreErrors, threads);
+		markClean();
+	}
+
+	/*
+	Reads the file and links it to this MinIni like open(), but through a binary image cached in cacheFilename.
+	If the image was saved from the current content of the file, it's loaded instead of parsing the file.
+	Otherwise the file is parsed, and the image is rebuilt for the next time.
+	The image is current if the file's size and modification time didn't change since it was saved,
+	or if only the time changed, but the file's hash stayed the same.
+	Returns whether the image was used. Errors with reading or writing the image are ignored, since it's only a cache.
+	*/
+	bool openCached(String filename, String cacheFilename, bool autosync, bool ignoreErrors = false) {
+		std::filesystem::path source(filename);
+		std::filesystem::path cache(cacheFilename);
+
+		try {
+			MappedFile file(cache.string());
+			if (isBinaryCurrent(checkBinary(file.data(), file.size()), source)) {
+				dataMap.clear();
+				touch(true);
+				readBinary(file.data(), file.size());
+				mFilename = filename;
+				mAutoSync = autosync;
+				markClean();
+				return true;
+			}
+		}
+		catch (const MappedFile::FileError&) {}
+		catch (const FormatException&) {}
+
+		// The stamp is taken before reading, so changes made while reading invalidate the image
+		_BinaryHeader stamp = binaryStamp(source);
+		open(filename, autosync, ignoreErrors);
+		if (stamp.hasSource && !isDirty()) {
+			std::vector<_BinarySectionView> sections = binarySections();
+			writeBinaryFile(cache, stamp, sections);
 		}
+		return false;
 	}
 
-	// Writes the content to the linked file. Throws FileError if the file can't be opened or isn't linked.
+	/*
+	Writes the content to the linked file. Throws FileError if the file can't be written or isn't linked.
+	The content is written to a temporary file next to it, which then atomically replaces the linked file,
+	so the file is never left half-written.
+	If dirty tracking is enabled and nothing was modified since the last open() or sync(), the file isn't written at all.
+	*/
 	void sync() const {
+		if (mFilename.empty()) {
+			throw FileError("No linked file specified to be synced to this MinIni!");
+		}
+		if (mDirtyTracking && !isDirty()) {
+			return;
+		}
+
+		std::filesystem::path path(mFilename);
+		std::filesystem::path tmpPath(path);
+		tmpPath += ".tmp";
+
 		FileStream file;
-		file.open(mFilename, std::ios::out);
+		file.open(tmpPath, std::ios::out | std::ios::trunc);
 
 		if (file.good()) {
 			write(file);
 			file.close();
+
+			std::error_code err;
+			if (!file.fail()) {
+				std::filesystem::rename(tmpPath, path, err);
+			}
+			if (file.fail() || err) {
+				std::filesystem::remove(tmpPath, err);
+				throw FileError(((std::stringstream&)(std::stringstream() <<
+					"Can't write ini file \"" << path.string() << "\"!")).str());
+			}
+			markClean();
 		}
 		else {
-			throw std::runtime_error(
-				mFilename.length()? 
-					((std::stringstream&)(std::stringstream() << 
-						"Can't open ini file \"" << std::string(mFilename.begin(), mFilename.end()) << "\"!")).str() :
-					"No linked file specified to be synced to this MinIni!");
+			throw FileError(((std::stringstream&)(std::stringstream() << 
+				"Can't open ini file \"" << path.string() << "\"!")).str());
 		}
 	}
 
@@ -275,6 +2498,8 @@ public:
 			sync();
 		}
 		dataMap.clear();
+		touch(true);
+		markClean();
 		mFilename = String();
 		mAutoSync = false;
 	}
@@ -0,0 +1,259 @@
+/*
+Made by Mauricius
+
+Part of my MUtilize repo: https://github.com/LegendaryMauricius/MUtilize
+*/
+
+#pragma once
+#ifndef _MIINI_LAYERED_H
+#define _MIINI_LAYERED_H
+
+#include <vector>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <atomic>
+#include <optional>
+#include "MiIni.h"
+
+/*
+Stacks several ini layers, e.g. defaults, a site file and host overrides, and looks the values up through all of them.
+A value is taken from the last added layer that has it, so layers are added from the lowest priority to the highest.
+The layers aren't copied, but shared through shared_ptrs, so one base layer can be used by any number of overlays.
+A layer can be a MiIni with any storage, a MiIniView, or any class with the same find() and revision() methods.
+
+Each resolved (section, key) is cached, including up to max_cached_misses keys that don't exist in any layer,
+so looking up many distinct missing keys doesn't grow the cache without bound.
+The cache is dropped whenever the revision() of a layer changes, so changes made through a layer's methods are seen right away.
+Lookups are thread-safe, as long as no thread modifies the layers at the same time.
+Cached values are read from an immutable snapshot, published through a std::atomic<std::shared_ptr>, without taking the cache's mutex.
+Note that the atomic shared_ptr isn't lock-free in every standard library, e.g. libstdc++ guards it with a short internal lock,
+but that lock is only held while copying the pointer. Values missing from the snapshot are resolved under the mutex,
+and the snapshot is republished once those lookups could have paid for copying it, so the copying stays amortized.
+*/
+template<class _StringT = std::string>
+class MiIniLayered
+{
+public:
+	using Char			= typename _StringT::value_type;
+	using String		= _StringT;
+	using StringView	= std::basic_string_view<Char>;
+
+	static constexpr size_t npos = (size_t)-1;
+	static constexpr size_t max_cached_misses = 4096;
+
+private:
+	using _IniT = MiIni<_StringT>;
+
+	struct Layer {
+		std::shared_ptr<const void> object;
+		std::optional<StringView>(*find)(const void* object, StringView sect, StringView key);
+		size_t(*revision)(const void* object);
+		String name;
+	};
+
+	struct Resolved {
+		size_t layer;// npos if no layer has the value
+		StringView value;
+	};
+
+	// Orders (section, key) pairs, so they can be looked up by pairs of views without building Strings
+	struct NameLess {
+		using is_transparent = void;
+
+		template<class _A, class _B>
+		bool operator()(const _A& a, const _B& b) const {
+			int cmp = StringView(a.first).compare(StringView(b.first));
+			return cmp < 0 || (cmp == 0 && StringView(a.second) < StringView(b.second));
+		}
+	};
+
+	using ResolvedMap = std::map<std::pair<String, String>, Resolved, NameLess>;
+
+	// Published values, which are never modified
+	struct Snapshot {
+		std::vector<size_t> revisions;// Of the layers when the values were resolved
+		ResolvedMap resolved;
+	};
+
+	std::vector<Layer> mLayers;// From the lowest priority to the highest
+	mutable std::atomic<std::shared_ptr<const Snapshot> > mSnapshot;// Read without taking the mutex
+	mutable std::mutex mCacheMutex;// Guards the members below
+	mutable std::vector<size_t> mCachedRevisions;
+	mutable ResolvedMap mCache;// Everything resolved since the layers last changed, including the snapshot's values
+	mutable size_t mSnapshotSize;
+	mutable size_t mSnapshotMisses;// Lookups of cached values that went past the snapshot since it was published
+	mutable size_t mCachedMisses;// Keys in the cache that don't exist in any layer
+
+	template<class _LayerT>
+	static std::optional<StringView> findIn(const void* object, StringView sect, StringView key) {
+		auto val = ((const _LayerT*)object)->find(sect, key);
+		if (!val)
+			return std::nullopt;
+		return StringView(*val);
+	}
+
+	template<class _LayerT>
+	static size_t revisionOf(const void* object) {
+		return ((const _LayerT*)object)->revision();
+	}
+
+	// Returns whether none of the layers changed since the revisions were taken
+	bool isCurrent(const std::vector<size_t>& revisions) const {
+		if (revisions.size() != mLayers.size())
+			return false;
+		for (size_t i = 0; i < mLayers.size(); i++) {
+			if (mLayers[i].revision(mLayers[i].object.get()) != revisions[i])
+				return false;
+		}
+		return true;
+	}
+
+	// Drops the cache. Needs mCacheMutex to be locked.
+	void clearCache() const {
+		mSnapshot.store(nullptr, std::memory_order_release);
+		mCache.clear();
+		mCachedRevisions.clear();
+		mSnapshotSize = 0;
+		mSnapshotMisses = 0;
+		mCachedMisses = 0;
+	}
+
+	Resolved resolve(StringView sect, StringView key) const {
+		std::shared_ptr<const Snapshot> snapshot = mSnapshot.load(std::memory_order_acquire);
+		if (snapshot && isCurrent(snapshot->revisions)) {
+			auto it = snapshot->resolved.find(std::make_pair(sect, key));
+			if (it != snapshot->resolved.end())
+				return it->second;
+		}
+		return resolveLocked(sect, key);
+	}
+
+	// Resolves the value through the cache that isn't published yet, and publishes it when it's due
+	Resolved resolveLocked(StringView sect, StringView key) const {
+		std::lock_guard<std::mutex> lock(mCacheMutex);
+		if (!isCurrent(mCachedRevisions)) {
+			clearCache();
+			for (const Layer& layer : mLayers)
+				mCachedRevisions.push_back(layer.revision(layer.object.get()));
+		}
+
+		Resolved res = { npos, StringView() };
+		auto it = mCache.find(std::make_pair(sect, key));
+		if (it != mCache.end()) {
+			res = it->second;
+		}
+		else {
+			for (size_t i = mLayers.size(); i-- > 0;) {
+				auto val = mLayers[i].find(mLayers[i].object.get(), sect, key);
+				if (val) {
+					res = { i, *val };
+					break;
+				}
+			}
+			if (res.layer == npos) {
+				// Past the limit, missing keys are resolved again on each lookup
+				if (mCachedMisses >= max_cached_misses)
+					return res;
+				mCachedMisses++;
+			}
+			mCache.emplace(std::make_pair(String(sect), String(key)), res);
+		}
+
+		if (++mSnapshotMisses > mSnapshotSize) {
+			mSnapshot.store(std::make_shared<const Snapshot>(Snapshot{ mCachedRevisions, mCache }), std::memory_order_release);
+			mSnapshotSize = mCache.size();
+			mSnapshotMisses = 0;
+		}
+		return res;
+	}
+
+public:
+
+	MiIniLayered() :
+		mSnapshotSize(0),
+		mSnapshotMisses(0),
+		mCachedMisses(0)
+	{}
+
+	MiIniLayered(const MiIniLayered&) = delete;
+	MiIniLayered& operator=(const MiIniLayered&) = delete;
+
+	/*
+	Adds the layer on top of the existing ones, giving it the highest priority.
+	The name is only used to tell where values come from (see layerOf()).
+	*/
+	template<class _LayerT>
+	void addLayer(std::shared_ptr<const _LayerT> layer, String name = String()) {
+		std::lock_guard<std::mutex> lock(mCacheMutex);
+		mLayers.push_back({ std::move(layer), &findIn<_LayerT>, &revisionOf<_LayerT>, std::move(name) });
+		clearCache();
+	}
+
+	template<class _LayerT>
+	void addLayer(std::shared_ptr<_LayerT> layer, String name = String()) {
+		addLayer(std::shared_ptr<const _LayerT>(std::move(layer)), std::move(name));
+	}
+
+	// Adds the layer without sharing its ownership. It has to outlive this MiIniLayered.
+	template<class _LayerT>
+	void addLayer(const _LayerT& layer, String name = String()) {
+		addLayer(std::shared_ptr<const _LayerT>(std::shared_ptr<const _LayerT>(), &layer), std::move(name));
+	}
+
+	size_t layerCount() const {
+		return mLayers.size();
+	}
+
+	const String& layerName(size_t layer) const {
+		return mLayers.at(layer).name;
+	}
+
+	// Drops the cache, e.g. after modifying a MiIni's dataMap directly without calling its invalidateHandles()
+	void invalidate() {
+		std::lock_guard<std::mutex> lock(mCacheMutex);
+		clearCache();
+	}
+
+	/*
+	Returns the value from the highest priority layer that has it.
+	The view points into the layer and stays valid while the layer's revision() doesn't change.
+	*/
+	std::optional<StringView> find(StringView sect, StringView key) const {
+		Resolved res = resolve(sect, key);
+		if (res.layer == npos)
+			return std::nullopt;
+		return res.value;
+	}
+
+	// Returns the index of the layer the value comes from, or npos if no layer has it
+	size_t layerOf(StringView sect, StringView key) const {
+		return resolve(sect, key).layer;
+	}
+
+	// Returns the value if it exists, or def if it doesn't
+	String getStr(StringView sect, StringView key, StringView def = StringView()) const {
+		auto val = find(sect, key);
+		return String(val ? *val : def);
+	}
+
+	// Returns the value if it exists, or def if it doesn't. Values are converted the same way as in MiIni::get().
+	template<class _T>
+	_T get(StringView sect, StringView key, _T def = _T()) const {
+		auto val = find(sect, key);
+		if (!val)
+			return def;
+		return _IniT::template fromString<_T>(*val);
+	}
+
+	String get(StringView sect, StringView key, const Char* def) const {
+		return getStr(sect, key, def);
+	}
+
+	// Returns whether any layer has the value
+	bool exists(StringView sect, StringView key) const {
+		return layerOf(sect, key) != npos;
+	}
+};
+
+#endif
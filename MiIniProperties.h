@@ -0,0 +1,127 @@
+/*
+Made by Mauricius
+
+Part of my MUtilize repo: https://github.com/LegendaryMauricius/MUtilize
+*/
+
+#pragma once
+#ifndef _MIINI_PROPERTIES_H
+#define _MIINI_PROPERTIES_H
+
+#include <type_traits>
+#include "MiIni.h"
+#include "DeclProperty.h"
+
+/*
+Loads and saves whole objects, whose properties are registered with 'reflect_properties', from and to ini sections.
+Each property is a key with the property's name.
+Values are converted the same way as in MiIni::get() and MiIni::set(), except that string properties get the whole value.
+Enums, including packed ones, are stored as numbers.
+The property names and accessors are known at compile time, so no maps are built for the binding,
+and parse() reads the text directly into the object, without storing it in a MiIni.
+Properties that can't be assigned, e.g. read-only ones, are skipped when loading.
+Properties with custom accessors need 'decl_value_type', so their values can be converted.
+Example:
+    MiIniProperties<>::load(settings, ini, "window");
+*/
+template<class _IniT = MiIni<> >
+class MiIniProperties
+{
+public:
+	using Char			= typename _IniT::Char;
+	using String		= typename _IniT::String;
+	using StringView	= typename _IniT::StringView;
+	using InputStream	= typename _IniT::InputStream;
+
+	static_assert(std::is_same<Char, char>::value, "Property names are narrow strings, so only narrow inis are supported!");
+
+private:
+	// Converts like MiIni::get(), except that strings get the whole value instead of its first word
+	template<class _ValueT>
+	static _ValueT fromString(StringView val) {
+		if constexpr (std::is_same<_ValueT, String>::value)
+			return String(val);
+		else
+			return _IniT::template fromString<_ValueT>(val);
+	}
+
+	// Assigns the value to the property with the key's name, if there is one
+	template<class _OwnerT>
+	static void assign(_OwnerT& obj, StringView key, StringView val) {
+		_OwnerT::for_each_property([&](auto info) {
+			using _ValueT = typename decltype(info)::value_t;
+			if constexpr (requires { info.get(obj) = fromString<_ValueT>(val); }) {
+				if (key == info.name)
+					info.get(obj) = fromString<_ValueT>(val);
+			}
+		});
+	}
+
+public:
+
+	/*
+	Sets the object's properties to the values in the section sect.
+	Properties without a value keep their current value.
+	*/
+	template<class _OwnerT>
+	static void load(_OwnerT& obj, const _IniT& ini, StringView sect) {
+		const typename _IniT::SectionMap* section = ini.findSection(sect);
+		if (!section)
+			return;
+		_OwnerT::for_each_property([&](auto info) {
+			using _ValueT = typename decltype(info)::value_t;
+			if constexpr (requires { info.get(obj) = fromString<_ValueT>(StringView()); }) {
+				auto it = section->find(StringView(info.name));
+				if (it != section->end())
+					info.get(obj) = fromString<_ValueT>(ini.valueOf(sect, info.name, it->second));
+			}
+		});
+	}
+
+	// Sets the values in the section sect to the object's properties
+	template<class _OwnerT>
+	static void save(_OwnerT& obj, _IniT& ini, StringView sect) {
+		_OwnerT::for_each_property([&](auto info) {
+			using _ValueT = typename decltype(info)::value_t;
+			static_assert(!std::is_void<_ValueT>::value, "The property's value type is unknown!");
+			ini.set(sect, info.name, (_ValueT)info.get(obj));
+		});
+	}
+
+	/*
+	Parses ini formatted text directly into the object's properties, reading only the section sect.
+	Other sections are skipped without being stored. Errors are handled the same way as in MiIni::readMore().
+	*/
+	template<class _OwnerT>
+	static void parse(_OwnerT& obj, StringView text, StringView sect, bool ignoreErrors = false) {
+		bool inSection = sect.empty();
+		_IniT::parse(text,
+			[&](StringView name) {
+				inSection = (name == sect);
+				return inSection ? _IniT::ParseAction::Continue : _IniT::ParseAction::SkipSection;
+			},
+			[&](StringView key, StringView val) {
+				if (inSection)
+					assign(obj, key, val);
+			},
+			ignoreErrors);
+	}
+
+	// Parses the stream into the object like parse() does for text, reading it through a fixed buffer
+	template<class _OwnerT>
+	static void parse(_OwnerT& obj, InputStream& is, StringView sect, bool ignoreErrors = false) {
+		bool inSection = sect.empty();
+		_IniT::parse(is,
+			[&](StringView name) {
+				inSection = (name == sect);
+				return inSection ? _IniT::ParseAction::Continue : _IniT::ParseAction::SkipSection;
+			},
+			[&](StringView key, StringView val) {
+				if (inSection)
+					assign(obj, key, val);
+			},
+			ignoreErrors);
+	}
+};
+
+#endif
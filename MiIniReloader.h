@@ -0,0 +1,211 @@
+/*
+Made by Mauricius
+
+Part of my MUtilize repo: https://github.com/LegendaryMauricius/MUtilize
+*/
+
+#pragma once
+#ifndef _MIINI_RELOADER_H
+#define _MIINI_RELOADER_H
+
+#include <memory>
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <functional>
+#include <exception>
+#include <filesystem>
+#include "MiIni.h"
+
+#ifdef __linux__
+#include <sys/inotify.h>
+#include <poll.h>
+#include <unistd.h>
+#endif
+
+/*
+Reloads an ini file into immutable MiIni snapshots, without stopping the threads that read it.
+Each reload parses the file into a fresh MiIni and then publishes it with an atomic shared_ptr swap,
+so readers always see either the old or the new content, never a half-parsed one.
+Readers take a snapshot with snapshot() and use its const methods (see MiIni's thread safety notes).
+A snapshot stays valid for as long as it's referenced, even after newer ones are published.
+*/
+template<class _IniT = MiIni<> >
+class MiIniReloader
+{
+public:
+	using Ini = _IniT;
+	using Snapshot = std::shared_ptr<const _IniT>;
+	using ErrorHandler = std::function<void(std::exception_ptr)>;
+
+private:
+	std::filesystem::path mFilename;
+	bool mIgnoreErrors;
+	std::atomic<Snapshot> mSnapshot;
+
+	std::mutex mReloadMutex;// Serializes the reloads
+	std::mutex mThreadMutex;// Guards the threads
+	std::mutex mHandlerMutex;// Guards the error handler
+	std::thread mReloadThread;
+	std::thread mWatchThread;
+	ErrorHandler mErrorHandler;
+#ifdef __linux__
+	int mStopPipe[2] = { -1, -1 };
+#endif
+
+	Snapshot parse() const {
+		auto ini = std::make_shared<_IniT>();
+		typename _IniT::FileStream file(mFilename, std::ios::in);
+		if (!file.good())
+			throw typename _IniT::FileError("Can't open ini file \"" + mFilename.string() + "\"!");
+		ini->read(file, mIgnoreErrors);
+		return ini;
+	}
+
+	// Reloads, passing the errors to the error handler instead of throwing them
+	void reloadNoThrow() {
+		try {
+			reload();
+		}
+		catch (...) {
+			ErrorHandler handler;
+			{
+				std::lock_guard<std::mutex> lock(mHandlerMutex);
+				handler = mErrorHandler;
+			}
+			if (handler)
+				handler(std::current_exception());
+		}
+	}
+
+#ifdef __linux__
+	void watch(int inotifyFd) {
+		std::string name = mFilename.filename().string();
+		alignas(struct inotify_event) char buf[4096];
+		pollfd fds[2] = { { inotifyFd, POLLIN, 0 }, { mStopPipe[0], POLLIN, 0 } };
+
+		for (;;) {
+			if (poll(fds, 2, -1) < 0)
+				continue;
+			if (fds[1].revents)
+				break;
+
+			bool changed = false;
+			ssize_t len = read(inotifyFd, buf, sizeof(buf));
+			for (ssize_t i = 0; i < len;) {
+				const struct inotify_event* ev = (const struct inotify_event*)(buf + i);
+				if (ev->len && name == ev->name)
+					changed = true;
+				i += sizeof(struct inotify_event) + ev->len;
+			}
+			if (changed)
+				reloadNoThrow();
+		}
+		close(inotifyFd);
+	}
+#endif
+
+public:
+
+	/*
+	Loads the file into the first snapshot.
+	Throws the same exceptions as MiIni::read(), or FileError if the file can't be opened.
+	*/
+	explicit MiIniReloader(const std::filesystem::path& filename, bool ignoreErrors = false) :
+		mFilename(filename),
+		mIgnoreErrors(ignoreErrors)
+	{
+		mSnapshot.store(parse(), std::memory_order_release);
+	}
+
+	MiIniReloader(const MiIniReloader&) = delete;
+	MiIniReloader& operator=(const MiIniReloader&) = delete;
+
+	~MiIniReloader() {
+		stopWatching();
+		std::lock_guard<std::mutex> lock(mThreadMutex);
+		if (mReloadThread.joinable())
+			mReloadThread.join();
+	}
+
+	const std::filesystem::path& filename() const {
+		return mFilename;
+	}
+
+	// The latest published snapshot. Cheap, lock-free and safe to call from any thread.
+	Snapshot snapshot() const {
+		return mSnapshot.load(std::memory_order_acquire);
+	}
+
+	/*
+	Parses the file into a new snapshot on the calling thread and publishes it.
+	If parsing fails the old snapshot stays published and the exception is rethrown.
+	*/
+	void reload() {
+		std::lock_guard<std::mutex> lock(mReloadMutex);
+		mSnapshot.store(parse(), std::memory_order_release);
+	}
+
+	/*
+	Reloads on a background thread, e.g. when requested by a signal handler's flag.
+	Errors are passed to the error handler, if one is set.
+	*/
+	void reloadAsync() {
+		std::lock_guard<std::mutex> lock(mThreadMutex);
+		if (mReloadThread.joinable())
+			mReloadThread.join();
+		mReloadThread = std::thread([this]() { reloadNoThrow(); });
+	}
+
+	// Sets the function that receives the errors of reloads done in the background
+	void setErrorHandler(ErrorHandler handler) {
+		std::lock_guard<std::mutex> lock(mHandlerMutex);
+		mErrorHandler = std::move(handler);
+	}
+
+	/*
+	Starts watching the local file for changes, reloading it in the background whenever it's written or replaced.
+	Returns false if watching isn't supported on this platform or the file's directory can't be watched.
+	*/
+	bool startWatching() {
+#ifdef __linux__
+		std::lock_guard<std::mutex> lock(mThreadMutex);
+		if (mWatchThread.joinable())
+			return true;
+
+		int fd = inotify_init1(IN_CLOEXEC);
+		if (fd < 0)
+			return false;
+		std::filesystem::path dir = mFilename.parent_path();
+		if (dir.empty())
+			dir = ".";
+		if (inotify_add_watch(fd, dir.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO) < 0 || pipe(mStopPipe) != 0) {
+			close(fd);
+			return false;
+		}
+
+		mWatchThread = std::thread([this, fd]() { watch(fd); });
+		return true;
+#else
+		return false;
+#endif
+	}
+
+	// Stops watching the file, if it's being watched
+	void stopWatching() {
+#ifdef __linux__
+		std::lock_guard<std::mutex> lock(mThreadMutex);
+		if (!mWatchThread.joinable())
+			return;
+
+		char stop = 0;
+		(void)!write(mStopPipe[1], &stop, 1);
+		mWatchThread.join();
+		close(mStopPipe[0]);
+		close(mStopPipe[1]);
+		mStopPipe[0] = mStopPipe[1] = -1;
+#endif
+	}
+};
+
+#endif
@@ -0,0 +1,378 @@
+/*
+Made by Mauricius
+
+Part of my MUtilize repo: https://github.com/LegendaryMauricius/MUtilize
+*/
+
+#pragma once
+#ifndef _MIINI_STATIC_H
+#define _MIINI_STATIC_H
+
+#include <array>
+#include <span>
+#include <optional>
+#include <algorithm>
+#include <bit>
+#include <limits>
+#include <cstdint>
+#include "MiIni.h"
+
+// A string literal that can be passed as a template argument, e.g. MiIniStatic<"[sect]\nkey = value\n">
+template<size_t N>
+struct MiIniLiteral
+{
+	char data[N];
+
+	constexpr MiIniLiteral(const char (&str)[N]) {
+		std::copy_n(str, N, data);
+	}
+
+	constexpr std::string_view view() const {
+		return std::string_view(data, N - 1);
+	}
+};
+
+// The compile-time parsing and hashing used by MiIniStatic
+struct MiIniStaticParser
+{
+	using _IniT = MiIni<std::string>;
+	using StringView = std::string_view;
+
+	struct Entry {
+		StringView section;
+		StringView key;
+		StringView value;
+	};
+
+	struct _RawEntry {
+		Entry entry;
+		size_t line;
+	};
+
+	template<size_t _N>
+	struct _Parsed {
+		std::array<_RawEntry, _N> entries;
+		size_t count;// Of the unique entries, which are at the front
+	};
+
+	/*
+	A hash-and-displace perfect hash table.
+	Entries are first hashed into buckets, and each bucket gets the seed that hashes its entries into free slots.
+	A lookup then costs two hashes and a single comparison.
+	*/
+	template<size_t _N>
+	struct Table {
+		static constexpr size_t bucketCount = _N / 4 + 1;
+		static constexpr size_t slotCount = std::bit_ceil(_N ? _N : 1);
+		static constexpr uint32_t emptySlot = UINT32_MAX;
+
+		std::array<Entry, _N> entries;// Sorted by section and key
+		std::array<uint32_t, bucketCount> seeds;
+		std::array<uint32_t, slotCount> slots;// Indices of the entries
+	};
+
+	// Counts the key-value pairs, including the duplicates
+	static constexpr size_t countEntries(StringView text) {
+		size_t count = 0;
+		for (size_t pos = 0; pos < text.size();) {
+			size_t end = std::min(text.find('\n', pos), text.size());
+			StringView first, second;
+			if (_IniT::tokenizeLine(text.substr(pos, end - pos), first, second) == _IniT::LineKind::KeyValue)
+				count++;
+			pos = end + 1;
+		}
+		return count;
+	}
+
+	// Parses the text into the entries sorted by section and key. Duplicate keys keep the last value, like in MiIni::readMore().
+	template<size_t _N>
+	static constexpr _Parsed<_N> parse(StringView text) {
+		_Parsed<_N> parsed = {};
+		StringView sect;
+		size_t count = 0;
+		size_t line = 0;
+		for (size_t pos = 0; pos < text.size();) {
+			size_t end = std::min(text.find('\n', pos), text.size());
+			line++;
+
+			StringView first, second;
+			switch (_IniT::tokenizeLine(text.substr(pos, end - pos), first, second)) {
+			case _IniT::LineKind::Section:
+				sect = first;
+				break;
+			case _IniT::LineKind::KeyValue:
+				parsed.entries[count++] = { { sect, first, second }, line };
+				break;
+			case _IniT::LineKind::Invalid:
+				// Reported as a compile error, since throwing isn't a constant expression
+				throw "Wrong ini file format in MiIniStatic!";
+			case _IniT::LineKind::Empty:
+				break;
+			}
+			pos = end + 1;
+		}
+
+		std::sort(parsed.entries.begin(), parsed.entries.end(), [](const _RawEntry& a, const _RawEntry& b) {
+			if (a.entry.section != b.entry.section) return a.entry.section < b.entry.section;
+			if (a.entry.key != b.entry.key) return a.entry.key < b.entry.key;
+			return a.line < b.line;
+		});
+
+		parsed.count = 0;
+		for (size_t i = 0; i < _N; i++) {
+			const Entry& e = parsed.entries[i].entry;
+			if (i + 1 < _N && e.section == parsed.entries[i + 1].entry.section && e.key == parsed.entries[i + 1].entry.key)
+				continue;
+			parsed.entries[parsed.count++] = parsed.entries[i];
+		}
+		return parsed;
+	}
+
+	// FNV-1a with a seed, followed by the MurmurHash3 finalizer for well distributed low bits
+	static constexpr uint64_t hash(StringView sect, StringView key, uint64_t seed) {
+		uint64_t h = 0xCBF29CE484222325ull ^ (seed * 0x9E3779B97F4A7C15ull);
+		for (char c : sect) {
+			h = (h ^ (unsigned char)c) * 0x100000001B3ull;
+		}
+		h = (h ^ sect.size()) * 0x100000001B3ull;
+		for (char c : key) {
+			h = (h ^ (unsigned char)c) * 0x100000001B3ull;
+		}
+		h ^= h >> 33;
+		h *= 0xFF51AFD7ED558CCDull;
+		h ^= h >> 33;
+		h *= 0xC4CEB9FE1A85EC53ull;
+		h ^= h >> 33;
+		return h;
+	}
+
+	template<size_t _N>
+	static constexpr size_t bucketOf(StringView sect, StringView key) {
+		return hash(sect, key, 0) % Table<_N>::bucketCount;
+	}
+
+	template<size_t _N>
+	static constexpr size_t slotOf(StringView sect, StringView key, uint32_t seed) {
+		return hash(sect, key, seed) & (Table<_N>::slotCount - 1);
+	}
+
+	template<size_t _N, size_t _RawN>
+	static constexpr Table<_N> buildTable(const _Parsed<_RawN>& parsed) {
+		Table<_N> table = {};
+		for (size_t i = 0; i < _N; i++) {
+			table.entries[i] = parsed.entries[i].entry;
+		}
+		table.seeds.fill(0);
+		table.slots.fill(Table<_N>::emptySlot);
+
+		// The entries grouped by bucket, with the biggest buckets first, since they are the hardest to place
+		std::array<size_t, Table<_N>::bucketCount> bucketSizes = {};
+		std::array<uint32_t, _N> order = {};
+		for (size_t i = 0; i < _N; i++) {
+			order[i] = (uint32_t)i;
+			bucketSizes[bucketOf<_N>(table.entries[i].section, table.entries[i].key)]++;
+		}
+		std::sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b) {
+			size_t ba = bucketOf<_N>(table.entries[a].section, table.entries[a].key);
+			size_t bb = bucketOf<_N>(table.entries[b].section, table.entries[b].key);
+			if (bucketSizes[ba] != bucketSizes[bb]) return bucketSizes[ba] > bucketSizes[bb];
+			if (ba != bb) return ba < bb;
+			return a < b;
+		});
+
+		for (size_t begin = 0; begin < _N;) {
+			size_t bucket = bucketOf<_N>(table.entries[order[begin]].section, table.entries[order[begin]].key);
+			size_t end = begin + bucketSizes[bucket];
+
+			uint32_t seed = 1;
+			for (;; seed++) {
+				if (seed == (1u << 20))
+					throw "Can't build the perfect hash table of MiIniStatic!";
+
+				bool placed = true;
+				for (size_t i = begin; i < end && placed; i++) {
+					const Entry& e = table.entries[order[i]];
+					size_t slot = slotOf<_N>(e.section, e.key, seed);
+					if (table.slots[slot] != Table<_N>::emptySlot)
+						placed = false;
+					for (size_t j = begin; j < i && placed; j++) {
+						const Entry& other = table.entries[order[j]];
+						if (slotOf<_N>(other.section, other.key, seed) == slot)
+							placed = false;
+					}
+				}
+				if (placed)
+					break;
+			}
+
+			table.seeds[bucket] = seed;
+			for (size_t i = begin; i < end; i++) {
+				const Entry& e = table.entries[order[i]];
+				table.slots[slotOf<_N>(e.section, e.key, seed)] = order[i];
+			}
+			begin = end;
+		}
+		return table;
+	}
+
+	/*
+	Converts the value the same way as MiIni::get(), but at compile time.
+	Supports string views, booleans and integers. Other types, e.g. floating point numbers, have to be converted at run time.
+	*/
+	template<class _T>
+	static constexpr _T convert(StringView str) {
+		if constexpr (std::is_same<_T, StringView>::value) {
+			return str;
+		}
+		else if constexpr (std::is_same<_T, bool>::value) {
+			str = _IniT::trimRight(str);
+			return str == "1" || str == "true";
+		}
+		else if constexpr (std::is_integral<_T>::value && _IniT::isCharsConvertible<_T>) {
+			if (str.size() > 1 && str[0] == '+' && str[1] != '-')
+				str.remove_prefix(1);
+
+			// Like from_chars, values that can't be parsed or are out of range result in 0
+			bool negative = (std::is_signed<_T>::value && !str.empty() && str[0] == '-');
+			if (negative)
+				str.remove_prefix(1);
+			size_t len = 0;
+			while (len < str.size() && str[len] >= '0' && str[len] <= '9') len++;
+			if (!len)
+				return _T();
+
+			using _U = std::make_unsigned_t<_T>;
+			_U limit = negative ? _U(std::numeric_limits<_T>::max()) + 1 : _U(std::numeric_limits<_T>::max());
+			_U ret = 0;
+			for (size_t i = 0; i < len; i++) {
+				_U digit = _U(str[i] - '0');
+				if (ret > (limit - digit) / 10)
+					return _T();
+				ret = ret * 10 + digit;
+			}
+			return negative ? _T(_U(0) - ret) : _T(ret);
+		}
+		else {
+			static_assert(std::is_same<_T, StringView>::value,
+				"Only string views, booleans and integers can be converted at compile time. Use get() for other types.");
+		}
+	}
+
+	template<class _T>
+	static _T fromString(StringView str) {
+		return _IniT::fromString<_T>(str);
+	}
+};
+
+/*
+An ini file embedded in the program, parsed at compile time into a perfectly hashed, sorted table in read-only memory.
+Typical use is for built-in defaults, which otherwise would be parsed on every startup:
+
+	using Defaults = MiIniStatic<R"(
+	[window]
+	width = 1280
+	fullscreen = false
+	)">;
+	constexpr int width = Defaults::value<"window", "width", int>();
+
+value() is checked at compile time, so misspelled sections and keys are compile errors.
+find(), get() and the other lookups also work at run time with any keys, in constant time.
+Since find() and revision() match MiIni's, the table can be the lowest layer of a MiIniLayered:
+
+	static constexpr Defaults defaults;
+	layered.addLayer(defaults, "defaults");
+
+The format and the errors match MiIni, except that improperly formatted lines are compile errors.
+Big embedded files may need a higher constexpr operation limit from the compiler (e.g. -fconstexpr-ops-limit in GCC).
+*/
+template<MiIniLiteral _Text>
+class MiIniStatic
+{
+public:
+	using Char			= char;
+	using String		= std::string;
+	using StringView	= std::string_view;
+	using Entry			= MiIniStaticParser::Entry;
+
+private:
+	using _P = MiIniStaticParser;
+
+	static constexpr size_t mRawCount = _P::countEntries(_Text.view());
+	static constexpr auto mParsed = _P::parse<mRawCount>(_Text.view());
+	static constexpr auto mTable = _P::buildTable<mParsed.count>(mParsed);
+
+public:
+
+	// Returns the value if it exists
+	static constexpr std::optional<StringView> find(StringView sect, StringView key) {
+		if constexpr (mParsed.count == 0) {
+			return std::nullopt;
+		}
+		else {
+			using _TableT = _P::Table<mParsed.count>;
+			uint32_t seed = mTable.seeds[_P::bucketOf<mParsed.count>(sect, key)];
+			uint32_t index = mTable.slots[_P::slotOf<mParsed.count>(sect, key, seed)];
+			if (index == _TableT::emptySlot)
+				return std::nullopt;
+			const Entry& e = mTable.entries[index];
+			if (e.section != sect || e.key != key)
+				return std::nullopt;
+			return e.value;
+		}
+	}
+
+	static constexpr bool exists(StringView sect, StringView key) {
+		return find(sect, key).has_value();
+	}
+
+	// Returns the value if it exists, or def if it doesn't
+	static constexpr StringView getStr(StringView sect, StringView key, StringView def = StringView()) {
+		auto val = find(sect, key);
+		return val ? *val : def;
+	}
+
+	// Returns the value if it exists, or def if it doesn't. Values are converted the same way as in MiIni::get().
+	template<class _T>
+	static _T get(StringView sect, StringView key, _T def = _T()) {
+		auto val = find(sect, key);
+		if (!val)
+			return def;
+		return _P::fromString<_T>(*val);
+	}
+
+	/*
+	Returns the value converted at compile time (see MiIniStaticParser::convert() for the supported types).
+	Fails to compile if the value doesn't exist.
+	*/
+	template<MiIniLiteral _Sect, MiIniLiteral _Key, class _T = StringView>
+	static consteval _T value() {
+		static_assert(exists(_Sect.view(), _Key.view()), "The value doesn't exist in the embedded ini!");
+		return _P::convert<_T>(*find(_Sect.view(), _Key.view()));
+	}
+
+	// All the values, sorted by section and key
+	static constexpr std::span<const Entry> entries() {
+		return std::span<const Entry>(mTable.entries.data(), mParsed.count);
+	}
+
+	// Number of unique keys in all sections
+	static constexpr size_t size() {
+		return mParsed.count;
+	}
+
+	// The content never changes, so neither does the revision (see MiIniLayered)
+	static constexpr size_t revision() {
+		return 0;
+	}
+
+	// Sets the values that don't exist in the ini, keeping the existing ones
+	template<class _IniT>
+	static void applyDefaults(_IniT& ini) {
+		for (const Entry& e : entries()) {
+			if (!ini.exists(e.section, e.key))
+				ini.setStr(e.section, e.key, e.value);
+		}
+	}
+};
+
+#endif
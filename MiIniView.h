@@ -0,0 +1,310 @@
+/*
+Made by Mauricius
+
+Part of my MUtilize repo: https://github.com/LegendaryMauricius/MUtilize
+*/
+
+#pragma once
+#ifndef _MIINI_VIEW_H
+#define _MIINI_VIEW_H
+
+#include <vector>
+#include <optional>
+#include <span>
+#include <algorithm>
+#include <cstdint>
+#include "MiIni.h"
+#include "MappedFile.h"
+
+/*
+A read-only view of an ini file, for configurations that never change after loading.
+The file is memory-mapped and indexed in a single pass, with sections and keys stored as offsets into the mapping,
+so no keys or values are copied and the bytes are shared through the page cache with other processes reading the same file.
+Values are returned as string_views into the mapping and stay valid for as long as the view is open.
+The format and the error handling match MiIni. Duplicate keys keep the last value, like in MiIni::readMore().
+With openCached() the view can also use a binary image written by MiIni, which is queried in place without any indexing.
+*/
+class MiIniView
+{
+public:
+	using Char			= char;
+	using String		= std::string;
+	using StringView	= std::string_view;
+	using FileError		= MiIni<String>::FileError;
+	using FormatException = MiIni<String>::FormatException;
+
+	// The index records, which have the same layout as in MiIni's binary images
+	using _Section		= MiIni<String>::_BinarySection;
+	using _Entry		= MiIni<String>::_BinaryEntry;
+
+private:
+	using _IniT = MiIni<String>;
+
+	MappedFile mFile;
+	const char* mBytes;
+	std::vector<_Section> mSections;
+	std::vector<_Entry> mEntries;
+	std::span<const _Section> mSectionIndex;// Sorted by name. Points to mSections or into a binary image.
+	std::span<const _Entry> mEntryIndex;// Grouped by section and sorted by key inside each section
+	size_t mRevision;
+
+	StringView str(uint64_t offset, uint32_t length) const {
+		return StringView(mBytes + offset, length);
+	}
+
+	const _Section* findSection(StringView sect) const {
+		auto it = std::lower_bound(mSectionIndex.begin(), mSectionIndex.end(), sect,
+			[this](const _Section& s, StringView name) { return str(s.nameOffset, s.nameLength) < name; });
+		if (it == mSectionIndex.end() || str(it->nameOffset, it->nameLength) != sect)
+			return nullptr;
+		return &*it;
+	}
+
+	// Builds the index of the text, which has to stay valid while the view is used
+	void index(StringView text, bool ignoreErrors) {
+		mBytes = text.data();
+		mSections.clear();
+		mEntries.clear();
+
+		// The owning section of each entry, by its position in mSections before sorting
+		std::vector<uint32_t> entrySections;
+		bool hasGlobalEntries = false;
+		size_t line = 0;
+		size_t pos = 0;
+
+		while (pos < text.size()) {
+			size_t end = text.find('\n', pos);
+			if (end == StringView::npos) {
+				end = text.size();
+			}
+			line++;
+
+			StringView first, second;
+			switch (_IniT::tokenizeLine(text.substr(pos, end - pos), first, second)) {
+			case _IniT::LineKind::Section:
+				mSections.push_back({ (uint64_t)(first.data() - mBytes), (uint32_t)first.size(), 0, 0 });
+				break;
+			case _IniT::LineKind::KeyValue:
+				mEntries.push_back({
+					(uint64_t)(first.data() - mBytes), (uint64_t)(second.data() - mBytes),
+					(uint32_t)first.size(), (uint32_t)second.size() });
+				if (mSections.empty()) {
+					hasGlobalEntries = true;
+					entrySections.push_back(UINT32_MAX);
+				}
+				else {
+					entrySections.push_back((uint32_t)mSections.size() - 1);
+				}
+				break;
+			case _IniT::LineKind::Invalid:
+				if (!ignoreErrors)
+					throw FormatException(((std::stringstream&)(std::stringstream() <<
+						"Wrong ini file format at line " << line << "!"
+						)).str(), line);
+				break;
+			case _IniT::LineKind::Empty:
+				break;
+			}
+
+			pos = end + 1;
+		}
+
+		// Sort the entries by section name and key, keeping the file order of duplicates so the last one wins
+		auto sectName = [&](uint32_t sectIndex) {
+			return sectIndex == UINT32_MAX ?
+				StringView() :
+				str(mSections[sectIndex].nameOffset, mSections[sectIndex].nameLength);
+		};
+		std::vector<uint32_t> order(mEntries.size());
+		for (size_t i = 0; i < order.size(); i++) order[i] = (uint32_t)i;
+		std::stable_sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b) {
+			int cmp = sectName(entrySections[a]).compare(sectName(entrySections[b]));
+			if (cmp != 0) return cmp < 0;
+			return str(mEntries[a].keyOffset, mEntries[a].keyLength) < str(mEntries[b].keyOffset, mEntries[b].keyLength);
+		});
+
+		// Collect the unique section names. The global section exists only if it has entries.
+		std::vector<_Section> sections = mSections;
+		if (hasGlobalEntries)
+			sections.push_back({ 0, 0, 0, 0 });
+		std::stable_sort(sections.begin(), sections.end(), [&](const _Section& a, const _Section& b) {
+			return str(a.nameOffset, a.nameLength) < str(b.nameOffset, b.nameLength);
+		});
+		sections.erase(std::unique(sections.begin(), sections.end(), [&](const _Section& a, const _Section& b) {
+			return str(a.nameOffset, a.nameLength) == str(b.nameOffset, b.nameLength);
+		}), sections.end());
+
+		// Store the entries grouped by section, dropping all but the last of each duplicate key
+		std::vector<_Entry> entries;
+		entries.reserve(mEntries.size());
+		size_t sectPos = 0;
+		for (size_t i = 0; i < order.size(); i++) {
+			const _Entry& e = mEntries[order[i]];
+			if (i + 1 < order.size() &&
+				sectName(entrySections[order[i]]) == sectName(entrySections[order[i + 1]]) &&
+				str(e.keyOffset, e.keyLength) == str(mEntries[order[i + 1]].keyOffset, mEntries[order[i + 1]].keyLength))
+				continue;
+
+			StringView sect = sectName(entrySections[order[i]]);
+			while (str(sections[sectPos].nameOffset, sections[sectPos].nameLength) != sect)
+				sectPos++;
+			if (!sections[sectPos].entryCount)
+				sections[sectPos].firstEntry = entries.size();
+			sections[sectPos].entryCount++;
+			entries.push_back(e);
+		}
+
+		mSections = std::move(sections);
+		mEntries = std::move(entries);
+		mSectionIndex = mSections;
+		mEntryIndex = mEntries;
+	}
+
+public:
+
+	MiIniView() :
+		mBytes(nullptr),
+		mRevision(0)
+	{}
+
+	/*
+	Maps and indexes the ini file.
+	Throws FileError if it can't be mapped and FormatException if it's not formatted properly, unless ignoreErrors is enabled.
+	*/
+	explicit MiIniView(const String& filename, bool ignoreErrors = false) :
+		MiIniView()
+	{
+		open(filename, ignoreErrors);
+	}
+
+	// Maps and indexes the ini file, replacing the current content. Errors are handled the same as in the constructor.
+	void open(const String& filename, bool ignoreErrors = false) {
+		close();
+		try {
+			mFile.open(filename);
+		}
+		catch (const MappedFile::FileError& e) {
+			throw FileError(e.what());
+		}
+		index(StringView(mFile.data(), mFile.size()), ignoreErrors);
+	}
+
+	/*
+	Indexes ini formatted text without copying it, replacing the current content.
+	The text must outlive the view, or its next open(), read() or close().
+	*/
+	void read(StringView text, bool ignoreErrors = false) {
+		close();
+		index(text, ignoreErrors);
+	}
+
+	/*
+	Opens the ini file through a binary image cached in cacheFilename, like MiIni::openCached().
+	If the image is current, it's mapped and queried in place, so opening only costs a pass over its records,
+	which checks that they point inside the image, and the page faults of the looked up data.
+	Otherwise the file is mapped and indexed like in open(), and the image is rebuilt for the next time.
+	Returns whether the image was used. Errors with reading or writing the image are ignored, since it's only a cache,
+	and a corrupted image is handled like an outdated one.
+	*/
+	bool openCached(const String& filename, const String& cacheFilename, bool ignoreErrors = false) {
+		close();
+		try {
+			mFile.open(cacheFilename);
+			const auto& header = _IniT::checkBinary(mFile.data(), mFile.size());
+			if (_IniT::isBinaryCurrent(header, filename)) {
+				_IniT::checkBinaryRecords(mFile.data(), header);
+				const _Section* sections = (const _Section*)(mFile.data() + sizeof(header));
+				const _Entry* entries = (const _Entry*)(sections + header.sectionCount);
+				mSectionIndex = std::span<const _Section>(sections, header.sectionCount);
+				mEntryIndex = std::span<const _Entry>(entries, header.entryCount);
+				mBytes = (const char*)(entries + header.entryCount);
+				return true;
+			}
+		}
+		catch (const MappedFile::FileError&) {}
+		catch (const FormatException&) {}
+
+		// The stamp is taken before reading, so changes made while reading invalidate the image
+		auto stamp = _IniT::binaryStamp(filename);
+		open(filename, ignoreErrors);
+		if (stamp.hasSource) {
+			std::vector<_IniT::_BinarySectionView> sections;
+			sections.reserve(mSectionIndex.size());
+			for (const _Section& sect : mSectionIndex) {
+				sections.push_back({ str(sect.nameOffset, sect.nameLength), {} });
+				for (const _Entry& e : mEntryIndex.subspan(sect.firstEntry, sect.entryCount)) {
+					sections.back().entries.emplace_back(str(e.keyOffset, e.keyLength), str(e.valueOffset, e.valueLength));
+				}
+			}
+			_IniT::writeBinaryFile(cacheFilename, stamp, sections);
+		}
+		return false;
+	}
+
+	void close() {
+		mSections.clear();
+		mEntries.clear();
+		mSectionIndex = {};
+		mEntryIndex = {};
+		mFile.close();
+		mBytes = nullptr;
+		mRevision++;
+	}
+
+	// Changes whenever the content is replaced or closed. Values returned by find() stay valid while it doesn't change.
+	size_t revision() const {
+		return mRevision;
+	}
+
+	// Returns the value if it exists, without copying it
+	std::optional<StringView> find(StringView sect, StringView key) const {
+		const _Section* s = findSection(sect);
+		if (!s)
+			return std::nullopt;
+
+		auto begin = mEntryIndex.begin() + s->firstEntry;
+		auto end = begin + s->entryCount;
+		auto it = std::lower_bound(begin, end, key,
+			[this](const _Entry& e, StringView k) { return str(e.keyOffset, e.keyLength) < k; });
+		if (it == end || str(it->keyOffset, it->keyLength) != key)
+			return std::nullopt;
+		return str(it->valueOffset, it->valueLength);
+	}
+
+	// Returns the value if it exists, or def if it doesn't
+	StringView getStr(StringView sect, StringView key, StringView def = StringView()) const {
+		auto val = find(sect, key);
+		return val ? *val : def;
+	}
+
+	// Returns the value if it exists, or def if it doesn't. Values are converted the same way as in MiIni::get().
+	template<class _T>
+	_T get(StringView sect, StringView key, _T def = _T()) const {
+		auto val = find(sect, key);
+		if (!val)
+			return def;
+		return _IniT::fromString<_T>(*val);
+	}
+
+	// Returns whether a section exists
+	bool exists(StringView sect) const {
+		return findSection(sect) != nullptr;
+	}
+
+	// Returns whether a value exists with the key in the section sect
+	bool exists(StringView sect, StringView key) const {
+		return find(sect, key).has_value();
+	}
+
+	// Number of unique sections
+	size_t sectionCount() const {
+		return mSectionIndex.size();
+	}
+
+	// Number of unique keys in all sections
+	size_t size() const {
+		return mEntryIndex.size();
+	}
+};
+
+#endif
@@ -8,7 +8,16 @@ Part of my MUtilize repo: https://github.com/LegendaryMauricius/MUtilize
 #define _SLOT_ARRAY_H
 
 #include <vector>
+#include <memory>
+#include <tuple>
+#include <cstring>
+#include <algorithm>
+#include <istream>
+#include <ostream>
+#include <cstdint>
+#include <type_traits>
 #include <stdexcept>
+#include "MappedFile.h"
 
 /*
 A random access class with the ability to free positions that are taken and find positions that are free without
@@ -23,6 +32,39 @@ private:
 	std::vector<unsigned char> mAreSlotsFree;// Whether a slot is free
 	size_t mSize;
 
+	// Takes all the slots in the range [first, last), growing the array if needed
+	void takeSlotRange(size_t first, size_t last)
+	{
+		size_t slots = mSlots.size();
+		if (last > slots)
+		{
+			mSlots.resize(last);
+			mAreSlotsFree.resize(last + 1, false);
+			mSize += last - slots;
+			last = slots;
+		}
+		if (first < last)
+		{
+			unsigned char* flags = mAreSlotsFree.data();
+			mSize += std::count(flags + first, flags + last, (unsigned char)true);
+			memset(flags + first, false, last - first);
+		}
+	}
+
+	// Removes the free slots from the end of the array
+	void trimFreeTail()
+	{
+		size_t count = mSlots.size();
+		while (count && mAreSlotsFree[count - 1])
+			count--;
+		if (count != mSlots.size())
+		{
+			mSlots.resize(count);
+			mAreSlotsFree.resize(count + 1);
+			mAreSlotsFree.back() = false;// Keep one non-free slot past the mSlots buffer
+		}
+	}
+
 public:
     using value_type      = _T;
     using allocator_type  = _Alloc;
@@ -277,10 +319,9 @@ public:
 
 	size_t getFreeSlot() const
 	{
-		for (size_t i = 0; i < mSlots.size(); i++) {
-			if (mAreSlotsFree[i])
-				return i;
-		}
+		const void* free = memchr(mAreSlotsFree.data(), 1, mSlots.size());
+		if (free)
+			return (const unsigned char*)free - mAreSlotsFree.data();
 		return mSlots.size();
 	}
 
@@ -289,11 +330,94 @@ public:
 		if (slot < mSlots.size() && !mAreSlotsFree[slot]) {
 			mAreSlotsFree[slot] = true;
 			mSize--;
-			while (mAreSlotsFree.size() && mAreSlotsFree.back()) {
-				mSlots.pop_back();
-				mAreSlotsFree.pop_back();
+			trimFreeTail();
+		}
+	}
+
+	/*
+	Takes count free slots in a single pass and appends their indices to outIndices.
+	The first run of free slots that can hold all of them is preferred, so the taken slots are contiguous when possible.
+	Otherwise the free slots are taken in order and the remaining ones are appended past the end.
+	*/
+	void acquireSlots(size_t count, std::vector<size_t>& outIndices)
+	{
+		outIndices.reserve(outIndices.size() + count);
+		const unsigned char* flags = mAreSlotsFree.data();
+		size_t slots = mSlots.size();
+
+		// Find the first free run that fits. A run reaching the end can always be extended.
+		size_t runBegin = slots;
+		for (size_t i = 0; i < slots;)
+		{
+			const void* free = memchr(flags + i, 1, slots - i);
+			if (!free)
+				break;
+			size_t b = (const unsigned char*)free - flags;
+			size_t e = b;
+			while (flags[e]) e++;// Stops at the non-free slot past the end
+			if (e - b >= count || e == slots)
+			{
+				runBegin = b;
+				break;
 			}
+			i = e;
 		}
+
+		if (runBegin != slots || count == 0)
+		{
+			takeSlotRange(runBegin, runBegin + count);
+			for (size_t i = runBegin; i < runBegin + count; i++)
+				outIndices.push_back(i);
+		}
+		else
+		{
+			// No run fits, so fill the holes and append the rest
+			size_t remaining = count;
+			for (size_t i = 0; i < slots && remaining;)
+			{
+				const void* free = memchr(flags + i, 1, slots - i);
+				if (!free)
+					break;
+				size_t b = (const unsigned char*)free - flags;
+				size_t e = b;
+				while (flags[e] && e - b < remaining) e++;
+				takeSlotRange(b, e);
+				for (size_t j = b; j < e; j++)
+					outIndices.push_back(j);
+				remaining -= e - b;
+				i = e;
+			}
+			takeSlotRange(slots, slots + remaining);
+			for (size_t j = slots; j < slots + remaining; j++)
+				outIndices.push_back(j);
+		}
+	}
+
+	// Frees all the slots with the given indices, trimming the array only once at the end
+	template<class _IndexRangeT>
+	void freeSlots(const _IndexRangeT& indices)
+	{
+		for (size_t slot : indices)
+		{
+			if (slot < mSlots.size() && !mAreSlotsFree[slot]) {
+				mAreSlotsFree[slot] = true;
+				mSize--;
+			}
+		}
+		trimFreeTail();
+	}
+
+	// Frees all the slots in the range [first, last)
+	void freeSlotRange(size_t first, size_t last)
+	{
+		if (last > mSlots.size())
+			last = mSlots.size();
+		if (first >= last)
+			return;
+		unsigned char* flags = mAreSlotsFree.data();
+		mSize -= (last - first) - std::count(flags + first, flags + last, (unsigned char)true);
+		memset(flags + first, true, last - first);
+		trimFreeTail();
 	}
 
 	void clear()
@@ -330,6 +454,138 @@ public:
 		return mSize;
 	}
 
+	/*
+	Snapshots
+	A snapshot stores the free slot flags followed by the raw slot block, so loading it keeps every slot at its index.
+	The layout is: _SnapshotHeader, slotCount + 1 free flags (the last one always 0), zero padding up to alignof(_T), slots.
+	It is meant to be read back on the same platform, as no byte order conversion is done.
+	*/
+
+	struct _SnapshotHeader {
+		char magic[4];
+		uint32_t version;
+		uint32_t elementSize;
+		uint32_t elementAlign;
+		uint64_t slotCount;
+		uint64_t size;
+	};
+
+	static const uint32_t snapshot_version = 1;
+
+	// Offset of the slot block from the start of a snapshot
+	static size_t _snapshotDataOffset(size_t slotCount)
+	{
+		size_t offset = sizeof(_SnapshotHeader) + slotCount + 1;
+		return (offset + alignof(_T) - 1) / alignof(_T) * alignof(_T);
+	}
+
+	// Total size of a snapshot with slotCount slots. Throws std::runtime_error if it doesn't fit in size_t.
+	static size_t _snapshotSize(uint64_t slotCount)
+	{
+		const size_t maxSlots = (SIZE_MAX - sizeof(_SnapshotHeader) - alignof(_T)) / (sizeof(_T) + 1) - 1;
+		if (slotCount > maxSlots)
+			throw std::runtime_error("Corrupted SlotArray snapshot!");
+		return _snapshotDataOffset((size_t)slotCount) + (size_t)slotCount * sizeof(_T);
+	}
+
+	// Reads count elements into the vector, growing it in bounded steps so a corrupted count can't force a huge allocation
+	template<class _VecT>
+	static bool _readSnapshotBlock(std::istream& is, _VecT& vec, size_t count)
+	{
+		const size_t step = ((size_t)1 << 20) / sizeof(typename _VecT::value_type) + 1;
+		vec.clear();
+		while (vec.size() < count) {
+			size_t offset = vec.size();
+			size_t n = std::min(step, count - offset);
+			vec.resize(offset + n);
+			if (!is.read((char*)(vec.data() + offset), n * sizeof(typename _VecT::value_type)))
+				return false;
+		}
+		return true;
+	}
+
+	// Throws std::runtime_error if the header doesn't describe a snapshot of this SlotArray type
+	static void _validateSnapshotHeader(const _SnapshotHeader& header)
+	{
+		if (memcmp(header.magic, "MSLA", 4) != 0)
+			throw std::runtime_error("Not a SlotArray snapshot!");
+		if (header.version != snapshot_version)
+			throw std::runtime_error("Unsupported SlotArray snapshot version!");
+		if (header.elementSize != sizeof(_T) || header.elementAlign != alignof(_T))
+			throw std::runtime_error("The SlotArray snapshot was saved with a different element type!");
+		if (header.size > header.slotCount)
+			throw std::runtime_error("Corrupted SlotArray snapshot!");
+	}
+
+	// Writes a snapshot of the array. Requires a trivially copyable _T.
+	void save(std::ostream& os) const
+	{
+		static_assert(std::is_trivially_copyable<_T>::value, "SlotArray snapshots require a trivially copyable type");
+
+		_SnapshotHeader header = {};
+		memcpy(header.magic, "MSLA", 4);
+		header.version = snapshot_version;
+		header.elementSize = sizeof(_T);
+		header.elementAlign = alignof(_T);
+		header.slotCount = mSlots.size();
+		header.size = mSize;
+
+		static const char padding[alignof(_T)] = {};
+		size_t flagsEnd = sizeof(_SnapshotHeader) + mAreSlotsFree.size();
+
+		os.write((const char*)&header, sizeof(header));
+		os.write((const char*)mAreSlotsFree.data(), mAreSlotsFree.size());
+		os.write(padding, _snapshotDataOffset(mSlots.size()) - flagsEnd);
+		os.write((const char*)mSlots.data(), mSlots.size() * sizeof(_T));
+
+		if (!os)
+			throw std::runtime_error("Can't write the SlotArray snapshot!");
+	}
+
+	/*
+	Replaces the content with a snapshot written by save().
+	Every slot keeps the index it had when saved. Requires a trivially copyable _T.
+	Throws std::runtime_error if the snapshot is invalid, in which case the array is left empty.
+	*/
+	void load(std::istream& is)
+	{
+		static_assert(std::is_trivially_copyable<_T>::value, "SlotArray snapshots require a trivially copyable type");
+
+		clear();
+
+		_SnapshotHeader header;
+		if (!is.read((char*)&header, sizeof(header)))
+			throw std::runtime_error("Can't read the SlotArray snapshot header!");
+		_validateSnapshotHeader(header);
+
+		size_t remaining = _snapshotSize(header.slotCount) - sizeof(_SnapshotHeader);
+
+		// Compare against the rest of the stream when it's seekable, before allocating anything
+		std::streambuf* buf = is.rdbuf();
+		std::streampos pos = buf->pubseekoff(0, std::ios_base::cur, std::ios_base::in);
+		if (pos != std::streampos(-1)) {
+			std::streampos end = buf->pubseekoff(0, std::ios_base::end, std::ios_base::in);
+			buf->pubseekpos(pos, std::ios_base::in);
+			if (end != std::streampos(-1) && (uint64_t)(end - pos) < remaining)
+				throw std::runtime_error("Corrupted SlotArray snapshot!");
+		}
+
+		size_t slots = (size_t)header.slotCount;
+		bool complete =
+			_readSnapshotBlock(is, mAreSlotsFree, slots + 1) &&
+			is.ignore(_snapshotDataOffset(slots) - sizeof(_SnapshotHeader) - (slots + 1)) &&
+			_readSnapshotBlock(is, mSlots, slots);
+
+		if (complete) {
+			mAreSlotsFree.back() = false;
+			mSize = slots - std::count(mAreSlotsFree.begin(), mAreSlotsFree.end(), (unsigned char)true);
+		}
+		if (!complete || mSize != header.size) {
+			clear();
+			throw std::runtime_error("Corrupted SlotArray snapshot!");
+		}
+	}
+
 	SlotArray<_T, _Alloc> operator=(const SlotArray<_T, _Alloc>& other)
 	{
 		mSlots = other.mSlots;
@@ -452,4 +708,504 @@ public:
 };
 
 
+/*
+A read-only SlotArray loaded from a snapshot file written by SlotArray::save().
+The file is memory-mapped and used in place after validating its header, so loading doesn't copy or construct the elements.
+Every slot keeps the index it had when saved. Requires a trivially copyable _T.
+*/
+template <class _T>
+class MappedSlotArray
+{
+	static_assert(std::is_trivially_copyable<_T>::value, "SlotArray snapshots require a trivially copyable type");
+
+private:
+	using _SnapshotHeader = typename SlotArray<_T>::_SnapshotHeader;
+
+	MappedFile mFile;
+	const _T* mSlots;
+	const unsigned char* mAreSlotsFree;
+	size_t mSlotCount;
+	size_t mSize;
+
+public:
+	using value_type      = _T;
+	using const_pointer   = const _T*;
+	using const_reference = const _T&;
+	using size_type       = size_t;
+	using difference_type = std::ptrdiff_t;
+	using const_iterator  = typename SlotArray<_T>::const_iterator;
+	using iterator        = const_iterator;
+
+	MappedSlotArray():
+		mSlots(nullptr),
+		mAreSlotsFree(nullptr),
+		mSlotCount(0),
+		mSize(0)
+	{}
+
+	// Maps the snapshot file. Throws a std::runtime_error if it can't be mapped or isn't a valid snapshot.
+	explicit MappedSlotArray(const std::string& filename):
+		MappedSlotArray()
+	{
+		open(filename);
+	}
+
+	/*
+	Maps the snapshot file, unmapping the previous one.
+	Throws a std::runtime_error if it can't be mapped or isn't a valid snapshot.
+	*/
+	void open(const std::string& filename)
+	{
+		close();
+		MappedFile file(filename);
+
+		if (file.size() < sizeof(_SnapshotHeader))
+			throw std::runtime_error("Not a SlotArray snapshot!");
+		_SnapshotHeader header;
+		memcpy(&header, file.data(), sizeof(header));
+		SlotArray<_T>::_validateSnapshotHeader(header);
+
+		if (file.size() < SlotArray<_T>::_snapshotSize(header.slotCount))
+			throw std::runtime_error("Corrupted SlotArray snapshot!");
+		size_t slots = (size_t)header.slotCount;
+		size_t dataOffset = SlotArray<_T>::_snapshotDataOffset(slots);
+		if (file.data()[sizeof(_SnapshotHeader) + slots] != 0)
+			throw std::runtime_error("Corrupted SlotArray snapshot!");
+
+		mFile = std::move(file);
+		mAreSlotsFree = (const unsigned char*)mFile.data() + sizeof(_SnapshotHeader);
+		mSlots = (const _T*)(mFile.data() + dataOffset);
+		mSlotCount = slots;
+		mSize = (size_t)header.size;
+	}
+
+	void close()
+	{
+		mFile.close();
+		mSlots = nullptr;
+		mAreSlotsFree = nullptr;
+		mSlotCount = 0;
+		mSize = 0;
+	}
+
+	const _T& operator[](size_t slot) const
+	{
+		if (slot < mSlotCount && !mAreSlotsFree[slot])
+		{
+			return mSlots[slot];
+		}
+		else
+		{
+			throw std::out_of_range("Trying to access a free slot of a MappedSlotArray.");
+		}
+	}
+
+	bool isSlotFree(size_t slot) const
+	{
+		if (slot < mSlotCount)
+			return mAreSlotsFree[slot];
+		return true;
+	}
+
+	size_t slotCount() const
+	{
+		return mSlotCount;
+	}
+
+	size_t size() const
+	{
+		return mSize;
+	}
+
+	/*
+	Iterators
+	*/
+
+	inline const_iterator begin() const noexcept {
+		if (!mSlotCount)
+			return end();
+		size_t first = 0;
+		while (mAreSlotsFree[first]) first++;
+		return const_iterator(mSlots + first, mAreSlotsFree + first);
+	}
+
+	inline const_iterator end() const noexcept {
+		return const_iterator(mSlots + mSlotCount, mAreSlotsFree + mSlotCount);
+	}
+
+	inline const_iterator cbegin() const noexcept {
+		return begin();
+	}
+
+	inline const_iterator cend() const noexcept {
+		return end();
+	}
+};
+
+/*
+A column of bools for SlotArraySoA.
+std::vector<bool> packs its elements into bits, so they can't be referenced or accessed through a pointer.
+This stores them in a plain bool array instead, with the part of the vector interface the columns use.
+*/
+class _SlotArrayBoolColumn
+{
+	std::unique_ptr<bool[]> mData;
+	size_t mSize;
+	size_t mCapacity;
+
+public:
+	_SlotArrayBoolColumn():
+		mSize(0),
+		mCapacity(0)
+	{}
+
+	_SlotArrayBoolColumn(const _SlotArrayBoolColumn& other):
+		_SlotArrayBoolColumn()
+	{
+		*this = other;
+	}
+
+	_SlotArrayBoolColumn(_SlotArrayBoolColumn&& other) noexcept:
+		mData(std::move(other.mData)),
+		mSize(other.mSize),
+		mCapacity(other.mCapacity)
+	{
+		other.mSize = 0;
+		other.mCapacity = 0;
+	}
+
+	_SlotArrayBoolColumn& operator=(const _SlotArrayBoolColumn& other)
+	{
+		if (this != &other) {
+			mSize = 0;
+			resize(other.mSize);
+			std::copy(other.data(), other.data() + other.mSize, data());
+		}
+		return *this;
+	}
+
+	_SlotArrayBoolColumn& operator=(_SlotArrayBoolColumn&& other) noexcept
+	{
+		mData = std::move(other.mData);
+		mSize = other.mSize;
+		mCapacity = other.mCapacity;
+		other.mSize = 0;
+		other.mCapacity = 0;
+		return *this;
+	}
+
+	// New elements are false
+	void resize(size_t count)
+	{
+		if (count > mCapacity) {
+			size_t capacity = std::max(count, mCapacity * 2);
+			std::unique_ptr<bool[]> grown(new bool[capacity]);
+			std::copy(data(), data() + mSize, grown.get());
+			mData = std::move(grown);
+			mCapacity = capacity;
+		}
+		if (count > mSize)
+			std::fill(data() + mSize, data() + count, false);
+		mSize = count;
+	}
+
+	void clear()
+	{
+		mSize = 0;
+	}
+
+	size_t size() const { return mSize; }
+	bool* data() { return mData.get(); }
+	const bool* data() const { return mData.get(); }
+	bool& operator[](size_t i) { return mData[i]; }
+	const bool& operator[](size_t i) const { return mData[i]; }
+};
+
+template<class _T>
+struct _SlotArrayColumn { using type = std::vector<_T>; };
+
+template<>
+struct _SlotArrayColumn<bool> { using type = _SlotArrayBoolColumn; };
+
+/*
+A structure-of-arrays variant of SlotArray for records made of several components.
+Each component type gets its own column array, while the information about which slots are free
+is shared by all columns, so the columns always stay in sync by index.
+Loops that only touch one column stream only that column's memory (see column()).
+bool columns, e.g. for flags, store one bool per slot, so they can be referenced like the other columns.
+Accessing a row will automatically take it, the same as with SlotArray.
+*/
+template <class... _Ts>
+class SlotArraySoA
+{
+	static_assert(sizeof...(_Ts) > 0, "SlotArraySoA needs at least one column type");
+
+private:
+	std::tuple<typename _SlotArrayColumn<_Ts>::type...> mColumns;
+	std::vector<unsigned char> mAreSlotsFree;// Whether a slot is free, shared by all columns
+	size_t mSize;
+
+	// Takes the slot, growing all the columns if needed
+	void takeSlot(size_t slot)
+	{
+		if (slot >= slotCount())
+		{
+			std::apply([&](auto&... cols) { (cols.resize(slot + 1), ...); }, mColumns);
+			mAreSlotsFree.back() = true;// The old past-the-end slot becomes a normal free slot
+			mAreSlotsFree.resize(slot + 2, true);
+			mAreSlotsFree[slot] = false;
+			mAreSlotsFree[slot + 1] = false;// Keep one non-free slot past the columns
+			mSize++;
+		}
+		else if (mAreSlotsFree[slot])
+		{
+			mAreSlotsFree[slot] = false;
+			mSize++;
+		}
+	}
+
+	// Removes the free slots from the end of the columns
+	void trimFreeTail()
+	{
+		size_t count = slotCount();
+		while (count && mAreSlotsFree[count - 1])
+			count--;
+		if (count != slotCount())
+		{
+			std::apply([&](auto&... cols) { (cols.resize(count), ...); }, mColumns);
+			mAreSlotsFree.resize(count + 1);
+			mAreSlotsFree.back() = false;
+		}
+	}
+
+	template<class _RowT, class _ColumnsT>
+	static _RowT makeRow(_ColumnsT& columns, size_t slot)
+	{
+		return std::apply([&](auto&... cols) { return _RowT(cols[slot]...); }, columns);
+	}
+
+public:
+	using size_type       = size_t;
+	using difference_type = std::ptrdiff_t;
+	using row_reference       = std::tuple<_Ts&...>;
+	using const_row_reference = std::tuple<const _Ts&...>;
+
+	template<size_t _I>
+	using column_type = std::tuple_element_t<_I, std::tuple<_Ts...> >;
+
+	static const size_t column_count = sizeof...(_Ts);
+
+	/*
+	Iterator definitions
+	*/
+
+	/*
+	Zipped iterator over the taken rows. Dereferencing it returns a tuple of references, one per column,
+	so it can be used with structured bindings.
+	It stores the row index, so it isn't invalidated when the columns' capacity changes.
+	*/
+	template<class _OwnerT, class _RowT>
+	class _RowIteratorImpl {
+	public:
+		using iterator_category = std::bidirectional_iterator_tag;
+		using value_type = _RowT;
+		using difference_type = std::ptrdiff_t;
+		using reference = _RowT;
+
+	private:
+		_OwnerT* mOwner;
+		size_t mInd;
+
+	public:
+		inline _RowIteratorImpl() noexcept {}
+		inline _RowIteratorImpl(size_t id, _OwnerT* owner) noexcept :
+			mOwner(owner),
+			mInd(id)
+		{
+		}
+		inline _RowIteratorImpl::reference operator*() const {
+			return makeRow<_RowT>(mOwner->mColumns, mInd);
+		}
+		// The index of the row this iterator points to
+		inline size_t slot() const noexcept {
+			return mInd;
+		}
+		inline _RowIteratorImpl& operator++() noexcept {
+			do {
+				mInd++;
+			} while (mOwner->mAreSlotsFree[mInd]);
+			return *this;
+		}
+		inline _RowIteratorImpl& operator--() noexcept {
+			do {
+				mInd--;
+			} while (mOwner->mAreSlotsFree[mInd]);
+			return *this;
+		}
+		inline _RowIteratorImpl operator++(int) noexcept {
+			_RowIteratorImpl old = *this;
+			++(*this);
+			return old;
+		}
+		inline _RowIteratorImpl operator--(int) noexcept {
+			_RowIteratorImpl old = *this;
+			--(*this);
+			return old;
+		}
+		inline bool operator==(const _RowIteratorImpl& it) const noexcept {
+			return mInd == it.mInd;
+		}
+		inline bool operator!=(const _RowIteratorImpl& it) const noexcept {
+			return mInd != it.mInd;
+		}
+	};
+
+	using iterator = _RowIteratorImpl<SlotArraySoA<_Ts...>, row_reference>;
+	using const_iterator = _RowIteratorImpl<const SlotArraySoA<_Ts...>, const_row_reference>;
+
+	/*
+	Actual SlotArraySoA methods
+	*/
+
+	static const size_t no_index = -1;
+
+	SlotArraySoA():
+		mSize(0)
+	{
+		mAreSlotsFree.push_back(false);// The slot past the columns isn't really free, so we mark it as that
+	}
+
+	// Takes the row and returns references to all of its components
+	row_reference operator[](size_t slot)
+	{
+		takeSlot(slot);
+		return makeRow<row_reference>(mColumns, slot);
+	}
+
+	const_row_reference operator[](size_t slot) const
+	{
+		if (slot < slotCount() && !mAreSlotsFree[slot])
+		{
+			return makeRow<const_row_reference>(mColumns, slot);
+		}
+		else
+		{
+			throw std::out_of_range("Trying to access a free slot of a const SlotArraySoA. "
+				"Accessing the slot's content would need to take the slot first, which is impossible since the SlotArraySoA is const.");
+		}
+	}
+
+	// Takes the row and returns a reference to its component from the column _I
+	template<size_t _I>
+	column_type<_I>& get(size_t slot)
+	{
+		takeSlot(slot);
+		return std::get<_I>(mColumns)[slot];
+	}
+
+	template<size_t _I>
+	const column_type<_I>& get(size_t slot) const
+	{
+		return std::get<_I>((*this)[slot]);
+	}
+
+	/*
+	Raw data of the column _I, containing slotCount() elements.
+	Elements of free slots are left in place, so check slotFreeFlags() when their content matters.
+	Pointers are invalidated when the slot count changes.
+	*/
+	template<size_t _I>
+	column_type<_I>* column() noexcept
+	{
+		return std::get<_I>(mColumns).data();
+	}
+
+	template<size_t _I>
+	const column_type<_I>* column() const noexcept
+	{
+		return std::get<_I>(mColumns).data();
+	}
+
+	// The free flag of each slot, shared by all the columns. Contains slotCount() + 1 elements, the last one always being 0.
+	const unsigned char* slotFreeFlags() const noexcept
+	{
+		return mAreSlotsFree.data();
+	}
+
+	size_t getFreeSlot() const
+	{
+		const void* free = memchr(mAreSlotsFree.data(), 1, slotCount());
+		if (free)
+			return (const unsigned char*)free - mAreSlotsFree.data();
+		return slotCount();
+	}
+
+	void freeSlot(size_t slot)
+	{
+		if (slot < slotCount() && !mAreSlotsFree[slot]) {
+			mAreSlotsFree[slot] = true;
+			mSize--;
+			trimFreeTail();
+		}
+	}
+
+	void clear()
+	{
+		std::apply([](auto&... cols) { (cols.clear(), ...); }, mColumns);
+		mAreSlotsFree.clear();
+		mAreSlotsFree.push_back(false);
+		mSize = 0;
+	}
+
+	bool isSlotFree(size_t slot) const
+	{
+		if (slot < slotCount())
+			return mAreSlotsFree[slot];
+		return true;
+	}
+
+	size_t slotCount() const
+	{
+		return mAreSlotsFree.size() - 1;
+	}
+
+	size_t size() const
+	{
+		return mSize;
+	}
+
+	/*
+	Iterators
+	*/
+
+	inline iterator begin() noexcept {
+		size_t first = 0;
+		while (mAreSlotsFree[first]) first++;
+		return iterator(first, this);
+	}
+
+	inline iterator end() noexcept {
+		return iterator(slotCount(), this);
+	}
+
+	inline const_iterator begin() const noexcept {
+		size_t first = 0;
+		while (mAreSlotsFree[first]) first++;
+		return const_iterator(first, this);
+	}
+
+	inline const_iterator end() const noexcept {
+		return const_iterator(slotCount(), this);
+	}
+
+	inline const_iterator cbegin() const noexcept {
+		return begin();
+	}
+
+	inline const_iterator cend() const noexcept {
+		return end();
+	}
+};
+
+
 #endif
\ No newline at end of file
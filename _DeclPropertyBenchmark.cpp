@@ -0,0 +1,266 @@
+#include <iostream>
+#include <chrono>
+#include <thread>
+#include <atomic>
+#include <mutex>
+#include <vector>
+#include <algorithm>
+#include <cstdlib>
+#include <cstdint>
+#include <utility>
+#include "DeclProperty.h"
+
+// The same entity with plain fields, and with properties that store the value, forward to the owner's field or are packed
+struct RawEntity
+{
+    int a, b;
+    uint32_t level : 8;
+    uint32_t flags : 24;
+};
+
+class PropEntity
+{
+public:
+    using property_owner_t = PropEntity;
+
+    decl_property(a,
+        enable_property_defaults(int);
+        default_get();
+        default_set();
+    );
+
+    decl_property(b,
+        decl_get(int)
+        {
+            return this_owner->bValue;
+        }
+        void decl_set(int val)
+        {
+            this_owner->bValue = val;
+        }
+    );
+
+    int bValue;
+
+    enable_packed_properties(uint32_t);
+
+    decl_packed_property(level, packed_start, uint32_t, 8,
+        packed_get();
+        packed_set();
+    );
+
+    decl_packed_property(flags, level, uint32_t, 24,
+        packed_get();
+        packed_set();
+    );
+};
+
+// Properties must not take any space of their own
+static_assert(sizeof(PropEntity) == sizeof(RawEntity));
+static_assert(sizeof(PropEntity::property_b_t) == 1);
+
+#if defined(_MSC_VER)
+#define CODEGEN_NOINLINE __declspec(noinline)
+#else
+#define CODEGEN_NOINLINE __attribute__((noinline))
+#endif
+
+/*
+The accessors compiled out of line, in pairs of a plain field access and the same property access.
+_DeclPropertyCodegen.sh compares their code sizes, which have to match if the properties compile to direct accesses.
+*/
+extern "C" {
+    CODEGEN_NOINLINE int codegen_raw_getA(RawEntity& e) { return e.a; }
+    CODEGEN_NOINLINE int codegen_prop_getA(PropEntity& e) { return e.a; }
+    CODEGEN_NOINLINE void codegen_raw_setA(RawEntity& e, int v) { e.a = v; }
+    CODEGEN_NOINLINE void codegen_prop_setA(PropEntity& e, int v) { e.a = std::move(v); }
+    CODEGEN_NOINLINE int codegen_raw_getB(RawEntity& e) { return e.b; }
+    CODEGEN_NOINLINE int codegen_prop_getB(PropEntity& e) { return e.b; }
+    CODEGEN_NOINLINE void codegen_raw_setB(RawEntity& e, int v) { e.b = v; }
+    CODEGEN_NOINLINE void codegen_prop_setB(PropEntity& e, int v) { e.b = v; }
+    CODEGEN_NOINLINE uint32_t codegen_raw_getLevel(RawEntity& e) { return e.level; }
+    CODEGEN_NOINLINE uint32_t codegen_prop_getLevel(PropEntity& e) { return e.level; }
+    CODEGEN_NOINLINE void codegen_raw_setLevel(RawEntity& e, uint32_t v) { e.level = v; }
+    CODEGEN_NOINLINE void codegen_prop_setLevel(PropEntity& e, uint32_t v) { e.level = v; }
+    CODEGEN_NOINLINE uint32_t codegen_raw_getFlags(RawEntity& e) { return e.flags; }
+    CODEGEN_NOINLINE uint32_t codegen_prop_getFlags(PropEntity& e) { return e.flags; }
+    CODEGEN_NOINLINE void codegen_raw_setFlags(RawEntity& e, uint32_t v) { e.flags = v; }
+    CODEGEN_NOINLINE void codegen_prop_setFlags(PropEntity& e, uint32_t v) { e.flags = v; }
+}
+
+template<class _EntityT>
+int accessLoop(std::vector<_EntityT>& entities, int rounds)
+{
+    int sum = 0;
+    for (int r = 0; r < rounds; r++) {
+        for (_EntityT& e : entities) {
+            e.b = e.a + r;
+            e.a = e.b - r + 1;
+            e.level = e.level + 1;
+            sum += e.b + (int)e.level;
+        }
+    }
+    return sum;
+}
+
+template<class _EntityT>
+double measureAccess(int& result)
+{
+    const size_t count = 4096;
+    const int rounds = 10000;
+    std::vector<_EntityT> entities(count);
+    for (size_t i = 0; i < count; i++) {
+        entities[i].a = (int)i;
+        entities[i].b = 0;
+        entities[i].level = (uint32_t)i;
+        entities[i].flags = (uint32_t)i;
+    }
+    auto start = std::chrono::steady_clock::now();
+    result = accessLoop(entities, rounds);
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+/*
+Compares property access against plain field access in a tight loop.
+Fails if the properties are measurably slower, i.e. if they don't compile to direct field accesses.
+Needs an optimized build, since unoptimized builds don't inline the property accessors.
+*/
+void benchmarkAccess()
+{
+    // The fastest of several alternating runs, to filter out the noise
+    int rawResult, propResult;
+    double rawTime = 1e9, propTime = 1e9;
+    for (int run = 0; run < 7; run++) {
+        rawTime = std::min(rawTime, measureAccess<RawEntity>(rawResult));
+        propTime = std::min(propTime, measureAccess<PropEntity>(propResult));
+    }
+
+    std::cout << "Field access:    " << rawTime << " s" << std::endl;
+    std::cout << "Property access: " << propTime << " s" << std::endl;
+    if (rawResult != propResult) {
+        std::cout << "Results differ!" << std::endl;
+        exit(1);
+    }
+    if (propTime > rawTime * 1.15) {
+        std::cout << "Property access is slower than field access!" << std::endl;
+        exit(1);
+    }
+}
+
+struct Range
+{
+    float min, max;
+};
+
+class Knobs
+{
+public:
+    using property_owner_t = Knobs;
+
+    decl_property(atomicGain,
+        enable_property_atomic(float, std::memory_order_acquire, std::memory_order_release);
+        atomic_get();
+        atomic_set();
+    );
+
+    decl_property(relaxedGain,
+        enable_property_atomic(float, std::memory_order_relaxed, std::memory_order_relaxed);
+        atomic_get();
+        atomic_set();
+    );
+
+    decl_property(seqlockRange,
+        enable_property_seqlock(Range);
+        atomic_get();
+        atomic_set();
+    );
+
+    // The baseline, locking a mutex around a plain value
+    decl_property(mutexRange,
+        decl_get(Range)
+        {
+            std::lock_guard<std::mutex> lock(this_owner->rangeMutex);
+            return this_owner->range;
+        }
+        void decl_set(const Range& val)
+        {
+            std::lock_guard<std::mutex> lock(this_owner->rangeMutex);
+            this_owner->range = val;
+        }
+    );
+
+    std::mutex rangeMutex;
+    Range range = { 0, 0 };
+};
+enable_this_owner(Knobs, mutexRange);
+
+/*
+Runs the readers and the single writer for the duration, and reports their throughput.
+The writer keeps both fields of the value equal, so the readers can detect torn reads.
+*/
+template<class _ReadF, class _WriteF>
+void benchmarkContention(const char* name, unsigned readers, _ReadF&& read, _WriteF&& write)
+{
+    const auto duration = std::chrono::milliseconds(500);
+    std::atomic<bool> stop(false);
+    std::atomic<size_t> reads(0), torn(0);
+    size_t writes = 0;
+
+    std::vector<std::thread> threads;
+    for (unsigned i = 0; i < readers; i++) {
+        threads.emplace_back([&]() {
+            size_t count = 0, tornCount = 0;
+            while (!stop.load(std::memory_order_relaxed)) {
+                if (!read())
+                    tornCount++;
+                count++;
+            }
+            reads += count;
+            torn += tornCount;
+        });
+    }
+    threads.emplace_back([&]() {
+        auto end = std::chrono::steady_clock::now() + duration;
+        while (std::chrono::steady_clock::now() < end) {
+            write((float)writes);
+            writes++;
+        }
+        stop = true;
+    });
+    for (auto& t : threads) {
+        t.join();
+    }
+
+    double seconds = std::chrono::duration<double>(duration).count();
+    std::cout << name << ": " << reads / seconds / 1e6 << " M reads/s, "
+        << writes / seconds / 1e6 << " M writes/s" << std::endl;
+    if (torn) {
+        std::cout << "Torn reads: " << torn << "!" << std::endl;
+        exit(1);
+    }
+}
+
+int main()
+{
+    benchmarkAccess();
+
+    // hardware_concurrency() returns 0 if it's unknown
+    unsigned hc = std::thread::hardware_concurrency();
+    unsigned readers = std::max(3u, hc > 1 ? hc - 1 : 3u);
+    std::cout << "Readers: " << readers << ", writers: 1" << std::endl;
+
+    Knobs knobs;
+    benchmarkContention("atomic<float> (acquire/release)", readers,
+        [&]() { volatile float v = knobs.atomicGain; (void)v; return true; },
+        [&](float v) { knobs.atomicGain = v; });
+    benchmarkContention("atomic<float> (relaxed)        ", readers,
+        [&]() { volatile float v = knobs.relaxedGain; (void)v; return true; },
+        [&](float v) { knobs.relaxedGain = v; });
+    benchmarkContention("seqlock<Range>                 ", readers,
+        [&]() { Range r = knobs.seqlockRange; return r.min == r.max; },
+        [&](float v) { knobs.seqlockRange = Range{ v, v }; });
+    benchmarkContention("mutex<Range>                   ", readers,
+        [&]() { Range r = knobs.mutexRange; return r.min == r.max; },
+        [&](float v) { knobs.mutexRange = Range{ v, v }; });
+    return 0;
+}
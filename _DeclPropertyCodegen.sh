@@ -0,0 +1,27 @@
+#!/bin/sh
+# Compiles the property benchmark with optimizations and compares the code size of each property accessor
+# (codegen_prop_*) with the matching plain field accessor (codegen_raw_*).
+# Fails if any property accessor is larger, i.e. if it doesn't compile to the same direct access.
+# Usage: ./_DeclPropertyCodegen.sh, with CXX set to use another compiler than g++
+set -e
+CXX=${CXX:-g++}
+OBJ=$(mktemp)
+trap 'rm -f "$OBJ"' EXIT
+
+"$CXX" -std=c++20 -O2 -Wno-attributes -c -x c++ "$(dirname "$0")/_DeclPropertyBenchmark.cpp" -o "$OBJ"
+
+nm -S -t d --defined-only "$OBJ" | awk '
+    $4 ~ /^codegen_raw_/ { raw[substr($4, 13)] = $2 + 0; names[count++] = substr($4, 13) }
+    $4 ~ /^codegen_prop_/ { prop[substr($4, 14)] = $2 + 0 }
+    END {
+        failed = (count == 0)
+        for (i = 0; i < count; i++) {
+            name = names[i]
+            printf "%-10s field: %3d bytes, property: %3d bytes\n", name, raw[name], prop[name]
+            if (!(name in prop) || prop[name] > raw[name]) {
+                print "The property accessor is larger than the field accessor!"
+                failed = 1
+            }
+        }
+        exit failed
+    }'
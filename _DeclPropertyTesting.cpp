@@ -17,12 +17,24 @@ public:
         void decl_set(int val)
         {
             this_owner->a = val - this_owner->b;
+            invalidate_dependents();
+        }
+        decl_invalidates(abSumSquared);
+    );
+
+    decl_cached_property(abSumSquared, int,
+        decl_compute()
+        {
+            std::cout << "(computing the square)" << std::endl;
+            int sum = this_owner->abSum;
+            return sum * sum;
         }
     );
 
     int a, b;
 };
 enable_this_owner(PropOwner, abSum);
+enable_this_owner(PropOwner, abSumSquared);
 
 int main() 
 {
@@ -38,11 +50,20 @@ int main()
 
     std::cout << "Sum is: " << (int)ops.abSum << std::endl;
 
+    // a and b were changed directly, so the cache has to be invalidated explicitly
+    ops.abSumSquared.invalidate();
+    for (int i = 0; i < 2; i++) {
+        int squared = ops.abSumSquared;
+        std::cout << "Sum squared is: " << squared << std::endl;
+    }
+
     std::cout << "Enter new sum: " << std::endl;
     int s;
     std::cin >> s;
     ops.abSum = s;
     std::cout << "Sum is: " << (int)ops.abSum << std::endl;
+    int squared = ops.abSumSquared;
+    std::cout << "Sum squared is: " << squared << std::endl;
 
     return 0;
 }
\ No newline at end of file
@@ -0,0 +1,392 @@
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <chrono>
+#include <cstdlib>
+#include <cstdint>
+#include <algorithm>
+#include <thread>
+#include <atomic>
+#include <new>
+#include <memory_resource>
+#include <fstream>
+#include <filesystem>
+#include "MiIni.h"
+#include "MiIniView.h"
+
+// Counts the heap allocations, to compare the memory use of the storages. Atomic, since the parallel parsing allocates too.
+static std::atomic<size_t> gAllocations(0);
+static std::atomic<size_t> gAllocatedBytes(0);
+
+void* operator new(size_t size)
+{
+    // The size is stored in front of the block, so that delete knows how much is freed
+    void* p = std::malloc(size + sizeof(std::max_align_t));
+    if (!p)
+        throw std::bad_alloc();
+    *(size_t*)p = size;
+    gAllocations.fetch_add(1, std::memory_order_relaxed);
+    gAllocatedBytes.fetch_add(size, std::memory_order_relaxed);
+    return (char*)p + sizeof(std::max_align_t);
+}
+
+void operator delete(void* p) noexcept
+{
+    if (!p)
+        return;
+    p = (char*)p - sizeof(std::max_align_t);
+    gAllocatedBytes.fetch_sub(*(size_t*)p, std::memory_order_relaxed);
+    std::free(p);
+}
+
+void operator delete(void* p, size_t) noexcept
+{
+    operator delete(p);
+}
+
+// Used by the polymorphic memory resources
+void* operator new(size_t size, std::align_val_t alignment)
+{
+    // The original block and the size are stored in front of the aligned block
+    size_t align = std::max((size_t)alignment, 2 * sizeof(size_t));
+    char* raw = (char*)std::malloc(size + align + 2 * sizeof(size_t));
+    if (!raw)
+        throw std::bad_alloc();
+    uintptr_t aligned = ((uintptr_t)raw + 2 * sizeof(size_t) + align - 1) / align * align;
+    ((size_t*)aligned)[-1] = size;
+    ((char**)aligned)[-2] = raw;
+    gAllocations.fetch_add(1, std::memory_order_relaxed);
+    gAllocatedBytes.fetch_add(size, std::memory_order_relaxed);
+    return (void*)aligned;
+}
+
+void operator delete(void* p, std::align_val_t) noexcept
+{
+    if (!p)
+        return;
+    gAllocatedBytes.fetch_sub(((size_t*)p)[-1], std::memory_order_relaxed);
+    std::free(((char**)p)[-2]);
+}
+
+void operator delete(void* p, size_t, std::align_val_t alignment) noexcept
+{
+    operator delete(p, alignment);
+}
+
+/*
+The line-by-line readMore() that MiIni used before the single pass parser.
+Kept here as the baseline to compare against.
+*/
+void legacyReadMore(MiIni<>& ini, std::istream& is)
+{
+    std::string sect;
+    std::string ln;
+    size_t line = 0;
+    while (std::getline(is, ln)) {
+        line++;
+        size_t commentPos;
+
+        std::stringstream spacesSS;
+        spacesSS << " \t\r\n";
+        std::string spaces = spacesSS.str();
+
+        ln.erase(0, ln.find_first_not_of(spaces));
+        ln.erase(ln.find_last_not_of(spaces) + 1);
+        if ((commentPos = ln.find_first_of('#')) != std::string::npos) {
+            ln.erase(commentPos);
+        }
+
+        if (ln.length()) {
+            if (ln[0] == '[') {
+                sect = ln.substr(1, ln.find_first_of(']') - 1);
+                sect.erase(0, sect.find_first_not_of(spaces));
+                sect.erase(sect.find_last_not_of(spaces) + 1);
+                ini.dataMap[sect];
+            }
+            else {
+                size_t eqpos = ln.find_first_of('=');
+                if (eqpos == std::string::npos) {
+                    throw MiIni<>::FormatException("Wrong ini file format", line);
+                }
+
+                std::string key = ln.substr(0, eqpos);
+                key.erase(key.find_last_not_of(spaces) + 1);
+                std::string val = ln.substr(eqpos + 1, std::string::npos);
+                val.erase(0, val.find_first_not_of(spaces));
+
+                ini.dataMap[sect][key] = val;
+            }
+        }
+    }
+}
+
+// The StringStream based get() that MiIni used before the from_chars conversions
+template<class _T>
+_T legacyGet(MiIni<>& ini, std::string sect, std::string key, _T def = _T())
+{
+    std::stringstream ss;
+    auto& keyvalmap = ini.dataMap[sect];
+
+    auto it = keyvalmap.find(key);
+    if (it == keyvalmap.end()) {
+        ss << def;
+        keyvalmap.insert(std::make_pair(key, ss.str()));
+        return def;
+    }
+    else {
+        ss << it->second;
+        _T ret;
+        ss >> ret;
+        return ret;
+    }
+}
+
+// Generates an ini file of roughly the given size in bytes
+std::string generateIni(size_t bytes)
+{
+    std::string text;
+    text.reserve(bytes + 256);
+    for (size_t sect = 0; text.size() < bytes; sect++) {
+        text += "[section_" + std::to_string(sect) + "]\n";
+        text += "# generated section\n";
+        for (size_t key = 0; key < 64; key++) {
+            text += "  key_" + std::to_string(key) + " = value " + std::to_string(sect * 64 + key) + "\n";
+        }
+        text += "\n";
+    }
+    return text;
+}
+
+template<class _F>
+double measureSeconds(_F&& f)
+{
+    auto start = std::chrono::steady_clock::now();
+    f();
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+void benchmarkParsing()
+{
+    const size_t size = 50 * 1024 * 1024;
+    std::string text = generateIni(size);
+    std::cout << "Ini size: " << text.size() / (1024 * 1024) << " MB" << std::endl;
+
+    MiIni<> legacyIni, streamIni, bufferIni;
+
+    double legacyTime = measureSeconds([&]() {
+        std::istringstream is(text);
+        legacyReadMore(legacyIni, is);
+    });
+    double streamTime = measureSeconds([&]() {
+        std::istringstream is(text);
+        streamIni.readMore(is);
+    });
+    double bufferTime = measureSeconds([&]() {
+        bufferIni.readMore(text);
+    });
+
+    std::cout << "Legacy readMore(istream): " << legacyTime << " s" << std::endl;
+    std::cout << "readMore(istream):        " << streamTime << " s" << std::endl;
+    std::cout << "readMore(string_view):    " << bufferTime << " s" << std::endl;
+
+    if (legacyIni.dataMap != streamIni.dataMap || legacyIni.dataMap != bufferIni.dataMap) {
+        std::cout << "Parsed content differs!" << std::endl;
+        exit(1);
+    }
+}
+
+void benchmarkParallelParsing()
+{
+    const size_t size = 100 * 1024 * 1024;
+    std::string text = generateIni(size);
+    std::cout << "Ini size: " << text.size() / (1024 * 1024) << " MB" << std::endl;
+
+    MiIni<> reference;
+    reference.readMore(text);
+
+    // Each run parses into a fresh MiIni, so that all of them allocate in the same conditions
+    auto measureParse = [&](unsigned threads) {
+        MiIni<> ini;
+        double time = measureSeconds([&]() {
+            if (threads)
+                ini.readMoreParallel(text, false, threads);
+            else
+                ini.readMore(text);
+        });
+        if (ini.dataMap != reference.dataMap) {
+            std::cout << "Parsed content differs!" << std::endl;
+            exit(1);
+        }
+        return time;
+    };
+
+    double serialTime = measureParse(0);
+    std::cout << "readMore:                     " << serialTime << " s" << std::endl;
+
+    unsigned maxThreads = std::max(2u, std::thread::hardware_concurrency());
+    for (unsigned threads = 1; threads <= maxThreads; threads *= 2) {
+        double parallelTime = measureParse(threads);
+        std::cout << "readMoreParallel(" << threads << " threads): " << parallelTime << " s, "
+            << serialTime / parallelTime << "x" << std::endl;
+    }
+}
+
+template<class _IniT>
+void benchmarkStorage(const char* name, const std::string& text)
+{
+    size_t allocationsBefore = gAllocations;
+    size_t bytesBefore = gAllocatedBytes;
+    _IniT ini;
+    double loadTime = measureSeconds([&]() {
+        ini.readMore(text);
+    });
+    size_t allocations = gAllocations - allocationsBefore;
+    size_t bytes = gAllocatedBytes - bytesBefore;
+
+    double destroyTime = measureSeconds([&]() {
+        ini.close();
+    });
+
+    std::cout << name << ": load " << loadTime << " s, " << allocations << " allocations, "
+        << bytes / (1024 * 1024) << " MB, clear " << destroyTime << " s" << std::endl;
+}
+
+void benchmarkStorages()
+{
+    std::string text = generateIni(50 * 1024 * 1024);
+    std::cout << "Ini size: " << text.size() / (1024 * 1024) << " MB" << std::endl;
+
+    benchmarkStorage<MiIni<> >("MiIniMapStorage", text);
+    benchmarkStorage<MiIni<std::string, MiIniHashStorage> >("MiIniHashStorage", text);
+    benchmarkStorage<MiIni<std::string, MiIniFlatStorage> >("MiIniFlatStorage", text);
+    benchmarkStorage<MiIni<std::string, MiIniArenaStorage> >("MiIniArenaStorage", text);
+    benchmarkStorage<MiIni<std::pmr::string, MiIniArenaStorage> >("MiIniArenaStorage (pmr::string)", text);
+}
+
+void benchmarkCache()
+{
+    const char* filename = "_MiIniBenchmark.ini";
+    const char* cacheFilename = "_MiIniBenchmark.ini.bin";
+    {
+        std::ofstream file(filename);
+        file << generateIni(50 * 1024 * 1024);
+    }
+    std::filesystem::remove(cacheFilename);
+
+    double openTime = measureSeconds([&]() {
+        MiIni<> ini;
+        ini.open(filename, false);
+    });
+    double rebuildTime = measureSeconds([&]() {
+        MiIni<> ini;
+        ini.openCached(filename, cacheFilename, false);
+    });
+    double cachedTime = measureSeconds([&]() {
+        MiIni<> ini;
+        ini.openCached(filename, cacheFilename, false);
+    });
+    double viewTime = measureSeconds([&]() {
+        MiIniView view;
+        view.open(filename);
+    });
+    double cachedViewTime = measureSeconds([&]() {
+        MiIniView view;
+        view.openCached(filename, cacheFilename);
+    });
+
+    std::cout << "MiIni::open:                    " << openTime << " s" << std::endl;
+    std::cout << "MiIni::openCached (rebuilding): " << rebuildTime << " s" << std::endl;
+    std::cout << "MiIni::openCached:              " << cachedTime << " s" << std::endl;
+    std::cout << "MiIniView::open:                " << viewTime << " s" << std::endl;
+    std::cout << "MiIniView::openCached:          " << cachedViewTime << " s" << std::endl;
+
+    std::filesystem::remove(filename);
+    std::filesystem::remove(cacheFilename);
+}
+
+void benchmarkUtf8()
+{
+    // Non-ASCII values, so that the validation can't take the ASCII fast path all the time
+    std::string ascii = generateIni(50 * 1024 * 1024);
+    std::string text;
+    std::wstring wtext;// The same text, as WMiIni would read it
+    text.reserve(ascii.size() + ascii.size() / 8);
+    wtext.reserve(ascii.size());
+    for (size_t pos = 0, next; pos < ascii.size(); pos = next + 5) {
+        next = std::min(ascii.find("value", pos), ascii.size());
+        text.append(ascii, pos, next - pos);
+        wtext.append(ascii.begin() + pos, ascii.begin() + next);
+        if (next < ascii.size()) {
+            text += "v\xC3\xA4lue";
+            wtext += L"v\u00E4lue";
+        }
+    }
+    std::cout << "Ini size: " << text.size() / (1024 * 1024) << " MB" << std::endl;
+
+    auto measureLoad = [&](const char* name, auto& ini, auto textView) {
+        size_t bytesBefore = gAllocatedBytes;
+        double time = measureSeconds([&]() {
+            ini.readMore(textView);
+        });
+        std::cout << name << time << " s, " << (gAllocatedBytes - bytesBefore) / (1024 * 1024) << " MB" << std::endl;
+    };
+
+    MiIni<> plainIni, validatedIni;
+    validatedIni.enableUtf8Validation();
+    WMiIni wideIni;
+    measureLoad("MiIni:                 ", plainIni, std::string_view(text));
+    measureLoad("MiIni (validated):     ", validatedIni, std::string_view(text));
+    measureLoad("WMiIni:                ", wideIni, std::wstring_view(wtext));
+
+    if (plainIni.dataMap != validatedIni.dataMap ||
+        plainIni.getWStr("section_1", "key_1") != wideIni.getStr(L"section_1", L"key_1"))
+    {
+        std::cout << "Parsed content differs!" << std::endl;
+        exit(1);
+    }
+}
+
+template<class _T>
+void benchmarkGetter(const char* typeName, MiIni<>& ini, const std::string& key)
+{
+    const size_t reads = 2000000;
+    volatile _T sink;
+
+    double legacyTime = measureSeconds([&]() {
+        for (size_t i = 0; i < reads; i++)
+            sink = legacyGet<_T>(ini, "numbers", key);
+    });
+    double newTime = measureSeconds([&]() {
+        for (size_t i = 0; i < reads; i++)
+            sink = ini.get<_T>("numbers", key);
+    });
+    (void)sink;
+
+    std::cout << "Legacy get<" << typeName << ">: " << reads / legacyTime / 1e6 << " M reads/s" << std::endl;
+    std::cout << "get<" << typeName << ">:        " << reads / newTime / 1e6 << " M reads/s" << std::endl;
+
+    if (legacyGet<_T>(ini, "numbers", key) != ini.get<_T>("numbers", key)) {
+        std::cout << "Converted values differ!" << std::endl;
+        exit(1);
+    }
+}
+
+void benchmarkGetters()
+{
+    MiIni<> ini;
+    ini.read(std::string_view("[numbers]\nint = -123456\ndouble = 3.25e-3\n"));
+
+    benchmarkGetter<int>("int", ini, "int");
+    benchmarkGetter<double>("double", ini, "double");
+}
+
+int main()
+{
+    benchmarkParsing();
+    benchmarkParallelParsing();
+    benchmarkStorages();
+    benchmarkCache();
+    benchmarkUtf8();
+    benchmarkGetters();
+    return 0;
+}
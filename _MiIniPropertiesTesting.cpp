@@ -0,0 +1,119 @@
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <cstdlib>
+#include "MiIniProperties.h"
+
+class WindowSettings
+{
+public:
+    using property_owner_t = WindowSettings;
+
+    enum class Mode { Windowed, Borderless, Fullscreen };
+    enum class Filter : uint8_t { Nearest, Linear, Anisotropic };
+
+    decl_property(width,
+        enable_property_defaults(int);
+        default_get();
+        default_set();
+    );
+
+    decl_property(title,
+        enable_property_defaults(std::string);
+        default_get();
+        default_set();
+    );
+
+    decl_property(mode,
+        enable_property_defaults(Mode);
+        default_get();
+        default_set();
+    );
+
+    decl_property(scale,
+        decl_value_type(double);
+        decl_get(double)
+        {
+            return this_owner->scaleValue;
+        }
+        void decl_set(double val)
+        {
+            this_owner->scaleValue = val;
+        }
+    );
+
+    enable_packed_properties(uint8_t);
+
+    decl_packed_property(vsync, packed_start, bool, 1,
+        packed_get();
+        packed_set();
+    );
+
+    decl_packed_property(filter, vsync, Filter, 2,
+        packed_get();
+        packed_set();
+    );
+
+    double scaleValue = 1;
+
+    reflect_properties(width, title, mode, scale, vsync, filter);
+};
+
+void check(bool condition, const char* what)
+{
+    if (!condition) {
+        std::cout << "Failed: " << what << std::endl;
+        exit(1);
+    }
+}
+
+int main()
+{
+    const char* text =
+        "[other]\n"
+        "width = 99\n"
+        "[window]\n"
+        "width = 1280\n"
+        "title = My ${window:width} app\n"
+        "mode = 2\n"
+        "scale = 1.5\n"
+        "vsync = true\n"
+        "filter = 2\n";
+
+    // Loading from a MiIni, with the references expanded
+    MiIni<> ini;
+    ini.read(std::string_view(text));
+    ini.enableInterpolation();
+    WindowSettings loaded;
+    MiIniProperties<>::load(loaded, ini, "window");
+    check(loaded.width == 1280, "load int");
+    check((std::string&)loaded.title == "My 1280 app", "load string");
+    check(loaded.mode == WindowSettings::Mode::Fullscreen, "load enum");
+    check((double)loaded.scale == 1.5, "load custom accessors");
+    check(loaded.vsync && loaded.filter == WindowSettings::Filter::Anisotropic, "load packed properties");
+
+    // Saving and loading back
+    MiIni<> saved;
+    MiIniProperties<>::save(loaded, saved, "window");
+    std::ostringstream os;
+    saved.write(os);
+    std::cout << os.str();
+    check(saved.getStr("window", "mode") == "2" && saved.getStr("window", "filter") == "2", "enums are saved as numbers");
+
+    WindowSettings reloaded;
+    MiIniProperties<>::load(reloaded, saved, "window");
+    check(reloaded.mode == loaded.mode && reloaded.filter == loaded.filter && reloaded.vsync, "round trip");
+
+    // Parsing directly into the object, without storing the text
+    WindowSettings parsed;
+    MiIniProperties<>::parse(parsed, std::string_view(text), "window");
+    check(parsed.width == 1280 && parsed.mode == WindowSettings::Mode::Fullscreen, "parse text");
+
+    std::istringstream is(text);
+    WindowSettings streamed;
+    MiIniProperties<>::parse(streamed, is, "other");
+    check(streamed.width == 99 && streamed.mode == WindowSettings::Mode::Windowed, "parse stream");
+
+    std::cout << "All checks passed" << std::endl;
+    return 0;
+}
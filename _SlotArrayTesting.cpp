@@ -0,0 +1,61 @@
+#include <iostream>
+#include <cstdlib>
+#include "SlotArray.h"
+
+struct Vec2
+{
+    float x, y;
+};
+
+void check(bool condition, const char* what)
+{
+    if (!condition) {
+        std::cout << "Failed: " << what << std::endl;
+        exit(1);
+    }
+}
+
+int main()
+{
+    // Positions with a flag column telling which entities are visible
+    SlotArraySoA<Vec2, bool> entities;
+
+    auto [pos, visible] = entities[3];
+    pos = Vec2{ 1, 2 };
+    visible = true;
+    entities.get<1>(5) = false;
+    entities[7] = std::tuple<Vec2, bool>(Vec2{ 3, 4 }, true);
+
+    check(entities.size() == 3 && entities.slotCount() == 8, "rows are taken on access");
+    check(std::get<1>(entities[3]) && !std::get<1>(entities[5]), "flags are stored per row");
+
+    // The flag column can be scanned directly
+    const bool* flags = entities.column<1>();
+    const unsigned char* freeFlags = entities.slotFreeFlags();
+    int visibleCount = 0;
+    for (size_t i = 0; i < entities.slotCount(); i++) {
+        if (!freeFlags[i] && flags[i])
+            visibleCount++;
+    }
+    check(visibleCount == 2, "the flag column is a plain bool array");
+
+    // Hide everything through the zipped iterator
+    int rows = 0;
+    for (auto [p, v] : entities) {
+        v = false;
+        p.x += 1;
+        rows++;
+    }
+    check(rows == 3, "iteration visits the taken rows");
+    check(!entities.column<1>()[3] && !entities.column<1>()[7], "iteration writes the flags");
+
+    const auto& constEntities = entities;
+    check(constEntities.get<0>(7).x == 4 && !constEntities.get<1>(7), "const access");
+
+    SlotArraySoA<Vec2, bool> copy = entities;
+    entities.freeSlot(7);
+    check(entities.slotCount() == 6 && copy.slotCount() == 8 && copy.column<0>()[7].x == 4, "copies are independent");
+
+    std::cout << "All checks passed" << std::endl;
+    return 0;
+}